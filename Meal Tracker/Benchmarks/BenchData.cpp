@@ -0,0 +1,219 @@
+//
+//  BenchData.cpp
+//  Meal Tracker
+//
+
+#include "BenchData.hpp"
+#include "Dates.hpp"
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <random>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char *WORDS[] = {"chicken", "salmon", "oats", "rice", "yogurt", "apple", "bagel", "cheese",
+                              "beef", "tofu", "pasta", "bread", "egg", "banana", "grapes", "almond"};
+static const int WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+int maxRows()
+{
+    static int rows = 0;
+    if (rows == 0)
+    {
+        const char *setting = getenv("MEAL_TRACKER_BENCH_MAX_ROWS");
+        rows = setting != nullptr && atoi(setting) >= 1000 ? atoi(setting) : 10000000;
+    }
+    return rows;
+}
+
+void rowCounts(benchmark::internal::Benchmark *bench)
+{
+    for (long long rows = 1000; rows <= maxRows(); rows *= 10)
+        bench->Arg((int)rows);
+}
+
+// short enough for the string to keep it inline, so ten million of them don't each take a heap block
+string foodName(int i)
+{
+    return string(WORDS[i % WORD_COUNT]) + " " + std::to_string(i);
+}
+
+const vector<Food> &syntheticFoods(int rows)
+{
+    static vector<Food> foods;
+    static int made = -1;
+    if (made != rows)
+    {
+        vector<Food>().swap(foods);
+        foods.reserve(rows);
+        std::mt19937 random(42);
+        std::uniform_int_distribution<int> calories(20, 800), tenths(0, 600);
+        for (int i = 0; i < rows; i++)
+        {
+            // one in five is listed by servings like the real dictionary's packaged foods
+            bool byServings = random() % 5 == 0;
+            foods.emplace_back(foodName(i), byServings ? 0 : 100, byServings ? 1 : 0, calories(random), tenths(random) / 10.0, tenths(random) / 6.0, tenths(random) / 12.0);
+        }
+        made = rows;
+    }
+    return foods;
+}
+
+vector<DayMacros> syntheticDays(int days)
+{
+    vector<DayMacros> history;
+    history.reserve(days);
+    std::mt19937 random(7);
+    std::normal_distribution<double> calories(2100.0, 350.0), grams(150.0, 30.0);
+    int first = epochDayToday() - days;
+    for (int i = 0; i < days; i++)
+        history.push_back(DayMacros{first + i, (int)calories(random), grams(random), grams(random) * 1.6, grams(random) * 0.45});
+    return history;
+}
+
+// the directory every data set goes in, removed when the benchmarks are done
+static struct Scratch
+{
+    string root;
+
+    ~Scratch()
+    {
+        if (!root.empty())
+        {
+            std::error_code ignored;
+            std::filesystem::remove_all(root, ignored);
+        }
+    }
+} scratch;
+
+string scratchPath(const string &name)
+{
+    if (scratch.root.empty())
+    {
+        const char *tmp = getenv("TMPDIR");
+        string pattern = string(tmp != nullptr && tmp[0] != '\0' ? tmp : "/tmp") + "/meal_tracker_bench.XXXXXX";
+        vector<char> path(pattern.begin(), pattern.end());
+        path.push_back('\0');
+        if (mkdtemp(path.data()) == nullptr)
+        {
+            perror("mkdtemp");
+            exit(1);
+        }
+        scratch.root = path.data();
+    }
+    string path = scratch.root + "/" + name;
+    mkdir(path.c_str(), 0755);
+    return path;
+}
+
+void enterDirectory(const string &name)
+{
+    if (chdir(scratchPath(name).c_str()) != 0)
+    {
+        perror("chdir");
+        exit(1);
+    }
+}
+
+void writeDictionaryCsv(const string &path, int rows)
+{
+    FILE *file = fopen(path.c_str(), "w");
+    if (file == nullptr)
+        return;
+    for (const Food &food : syntheticFoods(rows))
+        fprintf(file, "%s,%d,%d,%d,%g,%g,%g\n", food.getName().c_str(), food.getGrams(), food.getServings(), food.getCal(), food.getProtein(), food.getCarb(), food.getFat());
+    fclose(file);
+}
+
+void writeHistory(const string &profile, int days)
+{
+    string directory = "profiles/" + profile + "/";
+    mkdir("profiles", 0755);
+    mkdir(directory.c_str(), 0755);
+    MacroHistory history(directory + "MacrosHistory.dat", directory + "MacrosHistory.idx");
+    if (history.open(directory + "MacrosLog.txt"))
+        history.merge(syntheticDays(days));
+}
+
+string syntheticImport(int rows, bool json)
+{
+    vector<Food> foods = syntheticFoods(1000);
+    std::mt19937 random(11);
+    string text = json ? "" : "timestamp,food,grams,servings\n";
+    char line[160];
+    for (int i = 0; i < rows; i++)
+    {
+        const Food &food = foods[random() % foods.size()];
+        string date = isoDate(epochDayToday() - 1 - (int)(random() % 30));
+        int hour = 7 + (int)(random() % 14), minute = (int)(random() % 60);
+        int amount = food.getGrams() != 0 ? 50 + (int)(random() % 250) : 1 + (int)(random() % 3);
+        if (json && food.getGrams() != 0)
+            snprintf(line, sizeof(line), "{\"time\": \"%sT%02d:%02d\", \"food\": \"%s\", \"grams\": %d}\n", date.c_str(), hour, minute, food.getName().c_str(), amount);
+        else if (json)
+            snprintf(line, sizeof(line), "{\"time\": \"%sT%02d:%02d\", \"food\": \"%s\", \"servings\": %d}\n", date.c_str(), hour, minute, food.getName().c_str(), amount);
+        else if (food.getGrams() != 0)
+            snprintf(line, sizeof(line), "%sT%02d:%02d,%s,%d,\n", date.c_str(), hour, minute, food.getName().c_str(), amount);
+        else
+            snprintf(line, sizeof(line), "%sT%02d:%02d,%s,,%d\n", date.c_str(), hour, minute, food.getName().c_str(), amount);
+        text += line;
+    }
+    return text;
+}
+
+string syntheticLegacyLog(int foods)
+{
+    static const char *names[] = {"Egg Whites", "Tater Tots", "Fat Free Mozzarella Cheese", "Parmesean Bagel", "Avacado", "Nonfat Costco Yogurt", "Red Grapes", "Chicken Breast"};
+    std::mt19937 random(3);
+    string text;
+    char line[160];
+    time_t when = time(0) - (time_t)foods * 3600;
+    for (int i = 0; i < foods; i += 6)
+    {
+        when += 6 * 3600;
+        text += "Date: ";
+        text += ctime(&when);
+        int calories = 0;
+        for (int k = 0; k < 6 && i + k < foods; k++)
+        {
+            int grams = 30 + (int)(random() % 200), eaten = grams * 2;
+            calories += eaten;
+            snprintf(line, sizeof(line), "%s\nGrams:%d  Servings:0  Calories:%d  Protein:%g  Carbs:%g  Fat:%g\n", names[random() % 8], grams, eaten, grams * 0.21, grams * 0.4, grams * 0.07);
+            text += line;
+        }
+        snprintf(line, sizeof(line), "Todays Totals:\nCalories:%d  Protein:60  Carbs:106  Fats:30\n", calories);
+        text += line;
+        text += "----------------------------------------------------------------------------------\n";
+    }
+    return text;
+}
+
+int NullBuffer::overflow(int ch)
+{
+    return ch == EOF ? 0 : ch;
+}
+
+std::streamsize NullBuffer::xsputn(const char *, std::streamsize count)
+{
+    return count;
+}
+
+Console::Console()
+{
+    mCin = std::cin.rdbuf(mInput.rdbuf());
+    mCout = std::cout.rdbuf(&mNull);
+}
+
+Console::~Console()
+{
+    std::cin.rdbuf(mCin);
+    std::cout.rdbuf(mCout);
+    std::cin.clear();
+}
+
+void Console::script(const string &input)
+{
+    mInput.clear();
+    mInput.str(input);
+    std::cin.clear();
+}
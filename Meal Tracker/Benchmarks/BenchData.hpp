@@ -0,0 +1,68 @@
+//
+//  BenchData.hpp
+//  Meal Tracker
+//
+//  Made up dictionaries, histories and logs for meal_tracker_bench, and a
+//  console that feeds RunApp's prompts from a string and throws away what
+//  it prints. Everything is generated from a fixed seed so runs compare.
+//  The sizes go from 1k rows to MEAL_TRACKER_BENCH_MAX_ROWS, 10M if unset.
+//
+
+#ifndef BenchData_hpp
+#define BenchData_hpp
+#include "Food.hpp"
+#include "MacroHistory.hpp"
+#include <benchmark/benchmark.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdio.h>
+
+using std::string;
+using std::vector;
+using std::istringstream;
+using std::streambuf;
+
+int maxRows();
+void rowCounts(benchmark::internal::Benchmark *bench); // 1k, 10k, ... up to maxRows()
+
+string foodName(int i); // every i gets its own name, a few words get reused so searches find something
+const vector<Food> &syntheticFoods(int rows); // the last size asked for is kept, 10M foods don't fit twice
+vector<DayMacros> syntheticDays(int days); // consecutive days ending yesterday
+
+// Each data set gets a directory under one scratch directory for the run, removed at exit.
+// enterDirectory() makes it the working directory since RunApp only uses relative paths.
+string scratchPath(const string &name);
+void enterDirectory(const string &name);
+
+void writeDictionaryCsv(const string &path, int rows);
+void writeHistory(const string &profile, int days); // profiles/<profile>/MacrosHistory.dat in the working directory
+string syntheticImport(int rows, bool json); // what MealImport reads, foods from syntheticFoods(1000)
+string syntheticLegacyLog(int foods); // the pre-journal FoodLog.txt, six foods to a block
+
+class NullBuffer : public streambuf
+{
+protected:
+    int overflow(int ch) override;
+    std::streamsize xsputn(const char *, std::streamsize count) override;
+};
+
+class Console
+{
+public:
+    Console();
+    ~Console();
+    Console(const Console &) = delete;
+    Console &operator=(const Console &) = delete;
+
+    void script(const string &input); // what cin gives the next prompts
+
+private:
+    istringstream mInput;
+    NullBuffer mNull;
+    streambuf *mCin;
+    streambuf *mCout;
+};
+
+#endif /* BenchData_hpp */
@@ -0,0 +1,310 @@
+//
+//  CoreBench.cpp
+//  Meal Tracker
+//
+//  The pieces under RunApp on their own: the nutrient columns, range
+//  lookups, the planner, imports, the journal, the name pool and readers
+//  of the dictionary while it is being written.
+//
+
+#include "BenchData.hpp"
+#include "FoodDictionary.hpp"
+#include "NutrientTable.hpp"
+#include "NutrientIndex.hpp"
+#include "MealPlanner.hpp"
+#include "MealImport.hpp"
+#include "LegacyLog.hpp"
+#include "MealJournal.hpp"
+#include "NamePool.hpp"
+#include "MacroHistory.hpp"
+#include "Dates.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+using std::unique_ptr;
+
+// imports and old logs get big fast, they stop at a million rows
+static void importRowCounts(benchmark::internal::Benchmark *bench)
+{
+    for (int rows = 1000; rows <= std::min(maxRows(), 1000000); rows *= 10)
+        bench->Arg(rows);
+}
+
+static void BM_NutrientTableTotals(benchmark::State &state)
+{
+    int rows = (int)state.range(0);
+    NutrientTable table;
+    table.reserve(rows);
+    for (int i = 0; i < rows; i++)
+        table.add((uint32_t)(i % 64), 100, 0, 200 + i % 300, 10.5, 20.25, 5.125);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(table.totals());
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_NutrientTableTotals)->Apply(rowCounts);
+
+static void BM_NutrientTableAdd(benchmark::State &state)
+{
+    int rows = (int)state.range(0);
+    for (auto _ : state)
+    {
+        NutrientTable table;
+        for (int i = 0; i < rows; i++)
+            table.add((uint32_t)(i % 64), 100, 0, 250, 10.5, 20.25, 5.125);
+        benchmark::DoNotOptimize(table.size());
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_NutrientTableAdd)->Apply(rowCounts);
+
+static NutrientQuery highProtein()
+{
+    NutrientQuery query;
+    query.limit(PROTEIN, 40.0, 50.0);
+    query.limit(CALORIES, 100.0, 400.0);
+    return query;
+}
+
+static void BM_NutrientIndexFind(benchmark::State &state)
+{
+    const vector<Food> &foods = syntheticFoods((int)state.range(0));
+    NutrientIndex index;
+    NutrientQuery query = highProtein();
+    index.find(foods, query); // built on the first query
+    for (auto _ : state)
+        benchmark::DoNotOptimize(index.find(foods, query));
+}
+BENCHMARK(BM_NutrientIndexFind)->Apply(rowCounts)->Unit(benchmark::kMicrosecond);
+
+// the plain pass find() replaces
+static void BM_NutrientIndexScan(benchmark::State &state)
+{
+    const vector<Food> &foods = syntheticFoods((int)state.range(0));
+    NutrientQuery query = highProtein();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(NutrientIndex::scan(foods, query));
+    state.SetItemsProcessed(state.iterations() * foods.size());
+}
+BENCHMARK(BM_NutrientIndexScan)->Apply(rowCounts)->Unit(benchmark::kMicrosecond);
+
+static void BM_MealPlanner(benchmark::State &state)
+{
+    const vector<Food> &foods = syntheticFoods((int)state.range(0));
+    MealPlanner planner;
+    planner.setThreads(1);
+    Macros remaining;
+    remaining.add(750, 55.0, 80.0, 20.0);
+    for (auto _ : state)
+    {
+        MealPlan plan = planner.plan(foods, remaining);
+        benchmark::DoNotOptimize(plan.error);
+    }
+}
+BENCHMARK(BM_MealPlanner)->Apply(rowCounts)->Unit(benchmark::kMillisecond);
+
+// the dictionary of the last size asked for, indexed for find() and suggest()
+static FoodDictionary &dictionaryOf(int rows)
+{
+    static FoodDictionary dictionary;
+    static int made = -1;
+    if (made != rows)
+    {
+        dictionary.publish(syntheticFoods(rows));
+        made = rows;
+    }
+    return dictionary;
+}
+
+static void BM_Suggest(benchmark::State &state)
+{
+    FoodDictionary &dictionary = dictionaryOf((int)state.range(0));
+    const char *queries[] = {"salm", "chicken 12", "yogrt", "bagel 9"};
+    size_t next = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(dictionary.snapshot()->suggest(queries[next++ % 4], 5));
+}
+BENCHMARK(BM_Suggest)->Apply(rowCounts)->Unit(benchmark::kMicrosecond);
+
+// Readers look names up the way findFood does while one writer keeps adding foods, which copies the
+// dictionary and publishes it again. A reader only loads the snapshot again after a publish, so with
+// a core per thread items_per_second should grow with the threads; on fewer cores they just take turns.
+static void BM_SnapshotReadersUnderWrites(benchmark::State &state)
+{
+    static FoodDictionary *dictionary = nullptr;
+    static std::atomic<bool> writing(false);
+    static std::thread writer;
+    static std::atomic<long long> published(0);
+    if (state.thread_index() == 0)
+    {
+        dictionary = new FoodDictionary();
+        dictionary->publish(syntheticFoods(10000));
+        writing = true;
+        published = 0;
+        writer = std::thread([] {
+            Food food(foodName(99999), 100, 0, 120, 5.0, 10.0, 2.0);
+            while (writing)
+            {
+                dictionary->add(food);
+                published++;
+            }
+        });
+    }
+    vector<string> names;
+    for (int i = 0; i < 256; i++)
+        names.push_back(foodName(i * 37 % 10000));
+    size_t next = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(dictionary->current().find(names[next++ % names.size()]));
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0)
+    {
+        writing = false;
+        writer.join();
+        state.counters["publishes"] = benchmark::Counter((double)published, benchmark::Counter::kIsRate);
+        delete dictionary;
+        dictionary = nullptr;
+    }
+}
+BENCHMARK(BM_SnapshotReadersUnderWrites)->Threads(1)->Threads(2)->Threads(4)->Threads(8)->UseRealTime();
+
+static void BM_ImportCsv(benchmark::State &state)
+{
+    int rows = (int)state.range(0);
+    string text = syntheticImport(rows, false);
+    FoodDictionary &dictionary = dictionaryOf(1000);
+    for (auto _ : state)
+    {
+        MealImport import;
+        import.parse(text.data(), text.data() + text.size(), *dictionary.snapshot());
+        benchmark::DoNotOptimize(import.entries().size());
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+    state.SetBytesProcessed(state.iterations() * (int64_t)text.size());
+}
+BENCHMARK(BM_ImportCsv)->Apply(importRowCounts)->Unit(benchmark::kMillisecond);
+
+static void BM_ImportJsonl(benchmark::State &state)
+{
+    int rows = (int)state.range(0);
+    string text = syntheticImport(rows, true);
+    FoodDictionary &dictionary = dictionaryOf(1000);
+    for (auto _ : state)
+    {
+        MealImport import;
+        import.parse(text.data(), text.data() + text.size(), *dictionary.snapshot());
+        benchmark::DoNotOptimize(import.entries().size());
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+    state.SetBytesProcessed(state.iterations() * (int64_t)text.size());
+}
+BENCHMARK(BM_ImportJsonl)->Apply(importRowCounts)->Unit(benchmark::kMillisecond);
+
+// a million foods in the old FoodLog.txt layout, split between the given number of threads
+static void BM_LegacyLogParse(benchmark::State &state)
+{
+    static string text = syntheticLegacyLog(1000000);
+    int threads = (int)state.range(0);
+    for (auto _ : state)
+    {
+        LegacyLog log;
+        log.parse(text.data(), text.data() + text.size(), threads);
+        benchmark::DoNotOptimize(log.entries().size());
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)text.size());
+}
+BENCHMARK(BM_LegacyLogParse)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static SyncPolicy policyArg(int64_t arg)
+{
+    return arg == 0 ? SYNC_COMMIT : arg == 1 ? SYNC_PERIODIC : SYNC_NONE;
+}
+
+// one commit of the given number of foods, the second argument is the sync policy: 0 commit, 1 periodic, 2 none
+static void BM_JournalAppend(benchmark::State &state)
+{
+    enterDirectory("journal");
+    int batch = (int)state.range(0);
+    MealJournal journal("append-" + std::to_string(batch) + "-" + std::to_string(state.range(1)) + ".journal");
+    journal.setSyncPolicy(policyArg(state.range(1)));
+    vector<Food> foods(syntheticFoods(1000).begin(), syntheticFoods(1000).begin() + batch);
+    time_t now = time(0);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(journal.append(foods, now));
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_JournalAppend)->ArgsProduct({{1, 64}, {0, 1, 2}})->Unit(benchmark::kMicrosecond);
+
+// Every thread submits one food and waits for it, so commits that arrive while a write is going pile up and
+// share the next one. Synced on every commit.
+static void BM_JournalGroupCommit(benchmark::State &state)
+{
+    static MealJournal *journal = nullptr;
+    if (state.thread_index() == 0)
+    {
+        enterDirectory("journal");
+        journal = new MealJournal("group-" + std::to_string(state.threads()) + ".journal");
+        journal->setSyncPolicy(SYNC_COMMIT);
+    }
+    vector<Food> food(1, syntheticFoods(1000).front());
+    time_t now = time(0);
+    for (auto _ : state)
+    {
+        vector<Food> foods = food;
+        benchmark::DoNotOptimize(journal->wait(journal->submit(foods, now)));
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0)
+    {
+        delete journal;
+        journal = nullptr;
+    }
+}
+BENCHMARK(BM_JournalGroupCommit)->Threads(1)->Threads(2)->Threads(4)->Threads(8)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+// names that are already in the pool, which is what logging a food from the dictionary does
+static void BM_NamePoolIntern(benchmark::State &state)
+{
+    vector<string> names;
+    for (int i = 0; i < 4096; i++)
+        names.push_back(foodName(i));
+    for (const string &name : names)
+        foodNames().intern(name);
+    size_t next = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(foodNames().intern(names[next++ % names.size()]));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NamePoolIntern)->Threads(1)->Threads(4)->UseRealTime();
+
+static void BM_NamePoolName(benchmark::State &state)
+{
+    vector<uint32_t> ids;
+    for (int i = 0; i < 4096; i++)
+        ids.push_back(foodNames().intern(foodName(i)));
+    size_t next = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(foodNames().name(ids[next++ % ids.size()]).size());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NamePoolName)->Threads(1)->Threads(4)->UseRealTime();
+
+// thirty days out of a history of the given length
+static void BM_HistoryRange(benchmark::State &state)
+{
+    int days = (int)state.range(0);
+    enterDirectory("history-range");
+    string name = "range" + std::to_string(days);
+    MacroHistory history(name + ".dat", name + ".idx");
+    history.open(name + ".txt");
+    if (history.size() == 0)
+        history.merge(syntheticDays(days));
+    int last = history.lastDay(), next = 0;
+    for (auto _ : state)
+    {
+        int end = last - (next++ * 7919) % std::max(days - 30, 1);
+        benchmark::DoNotOptimize(history.range(end - 29, end));
+    }
+}
+BENCHMARK(BM_HistoryRange)->Apply(rowCounts)->Unit(benchmark::kMicrosecond);
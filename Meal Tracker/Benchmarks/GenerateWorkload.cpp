@@ -0,0 +1,69 @@
+//
+//  GenerateWorkload.cpp
+//  Meal Tracker
+//
+//  meal_tracker_gen [--foods n] [--years n | --days n] [--seed n] [--out dir]
+//
+//  Writes FoodData.csv, FoodLog.txt, MacrosLog.txt and MacroGoals.txt into
+//  dir (the working directory by default), see Workload.hpp. Run the app
+//  in that directory to use them; menu option 20 moves FoodLog.txt into the
+//  journal.
+//
+
+#include "Workload.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sys/stat.h>
+
+using std::cout;
+using std::endl;
+
+static void usage()
+{
+    cout << "usage: meal_tracker_gen [--foods n] [--years n | --days n] [--seed n] [--out dir]" << endl;
+    cout << "  defaults: 100000 foods, 20 years of logs ending yesterday, seed 42, the current directory" << endl;
+}
+
+int main(int argc, const char * argv[]) {
+    WorkloadOptions options;
+    string out = ".";
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--foods" && hasValue)
+            options.foods = atoi(argv[++i]);
+        else if (arg == "--years" && hasValue)
+            options.days = (int)(atof(argv[++i]) * 365.25);
+        else if (arg == "--days" && hasValue)
+            options.days = atoi(argv[++i]);
+        else if (arg == "--seed" && hasValue)
+            options.seed = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--out" && hasValue)
+            out = argv[++i];
+        else
+        {
+            usage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (options.foods < 1 || options.days < 0)
+    {
+        usage();
+        return 1;
+    }
+    mkdir(out.c_str(), 0755);
+
+    auto started = std::chrono::steady_clock::now();
+    Workload workload(options);
+    if (!workload.writeFoodData(out + "/FoodData.csv") || !workload.writeLogs(out + "/FoodLog.txt", out + "/MacrosLog.txt") || !workload.writeGoals(out + "/MacroGoals.txt"))
+    {
+        cout << "error Writing to " << out << endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    const WorkloadCounts &counts = workload.counts();
+    cout << counts.foods << " foods in FoodData.csv, " << counts.eaten << " foods in " << counts.meals << " meals in FoodLog.txt, " << counts.days << " days in MacrosLog.txt (" << seconds << " s)" << endl;
+    return 0;
+}
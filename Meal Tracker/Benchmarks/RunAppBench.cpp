@@ -0,0 +1,384 @@
+//
+//  RunAppBench.cpp
+//  Meal Tracker
+//
+//  The menu's hot paths, driven through RunApp itself with the prompts
+//  answered from a script. Each benchmark works in its own scratch
+//  directory, RunApp reads and writes its files relative to it.
+//
+
+#include "RunApp.hpp"
+#include "BenchData.hpp"
+#include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+static const char *GOALS = "2000,150,250,70\n";
+
+static void writeFile(const string &path, const string &text)
+{
+    FILE *file = fopen(path.c_str(), "w");
+    if (file == nullptr)
+        return;
+    fwrite(text.data(), 1, text.size(), file);
+    fclose(file);
+}
+
+static bool fileExists(const string &path)
+{
+    struct stat info;
+    return stat(path.c_str(), &info) == 0;
+}
+
+// a directory with a FoodData.csv of the given size and goals for the default profile
+static void enterDictionary(const string &name, int rows)
+{
+    enterDirectory(name + std::to_string(rows));
+    if (!fileExists("FoodData.csv"))
+        writeDictionaryCsv("FoodData.csv", rows);
+    if (!fileExists("MacroGoals.txt"))
+        writeFile("MacroGoals.txt", GOALS);
+}
+
+static void enterProfile(const string &profile, int days)
+{
+    if (fileExists("profiles/" + profile + "/MacrosHistory.dat"))
+        return;
+    writeHistory(profile, days);
+    writeFile("profiles/" + profile + "/MacroGoals.txt", GOALS);
+}
+
+static void BM_ReadFileCsv(benchmark::State &state)
+{
+    int rows = (int)state.range(0);
+    enterDictionary("dictionary", rows);
+    Console console;
+    RunApp app;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        unlink("FoodData.bin"); // no snapshot, so the csv gets parsed and the snapshot written again
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(app.readFile());
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_ReadFileCsv)->Apply(rowCounts)->Unit(benchmark::kMillisecond);
+
+static void BM_ReadFileSnapshot(benchmark::State &state)
+{
+    int rows = (int)state.range(0);
+    enterDictionary("dictionary", rows);
+    Console console;
+    RunApp app;
+    app.readFile();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(app.readFile());
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_ReadFileSnapshot)->Apply(rowCounts)->Unit(benchmark::kMillisecond);
+
+// one food added through the prompts each time, so there is something to save
+static void BM_SaveDictionary(benchmark::State &state)
+{
+    int rows = (int)state.range(0);
+    enterDictionary("save", rows);
+    Console console;
+    RunApp app;
+    app.readFile();
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        console.script("1\n100\n250\n20\n30\n10\n");
+        app.addFoodToDictionary("bench food");
+        state.ResumeTiming();
+        app.saveDictionary();
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_SaveDictionary)->Apply(rowCounts)->Unit(benchmark::kMillisecond);
+
+// the names asked for, spread over the whole dictionary
+static vector<string> lookups(int rows)
+{
+    vector<string> names;
+    for (int i = 0; i < 1024; i++)
+        names.push_back(foodName((int)((i * 2654435761u) % (unsigned)rows)));
+    return names;
+}
+
+static void BM_FindFood(benchmark::State &state)
+{
+    int rows = (int)state.range(0);
+    enterDictionary("dictionary", rows);
+    Console console;
+    RunApp app;
+    app.readFile();
+    vector<string> names = lookups(rows);
+    size_t next = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(app.findFood(names[next++ % names.size()]));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindFood)->Apply(rowCounts);
+
+// the whole prompt: the name is looked up, then the portion worked out from one number
+static void BM_CalculateFoodMacros(benchmark::State &state)
+{
+    int rows = (int)state.range(0);
+    enterDictionary("dictionary", rows);
+    Console console;
+    RunApp app;
+    app.readFile();
+    vector<string> scripts;
+    for (const string &name : lookups(rows))
+        scripts.push_back("\n" + name + "\n2\n"); // calculateFoodMacros skips a character before reading the name
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        console.script(scripts[next++ % scripts.size()]);
+        Food food = app.calculateFoodMacros();
+        benchmark::DoNotOptimize(food);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CalculateFoodMacros)->Apply(rowCounts);
+
+// Reloading the dictionary drops the sorted views, so every print sorts. The second argument is the menu's
+// sort choice, 1 by name and 2 by calories.
+static void BM_PrintDictionarySort(benchmark::State &state)
+{
+    int rows = (int)state.range(0);
+    enterDictionary("dictionary", rows);
+    Console console;
+    RunApp app;
+    app.readFile();
+    string script = std::to_string(state.range(1)) + "\n2\n20\n";
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        app.readFile();
+        console.script(script);
+        state.ResumeTiming();
+        app.printDictionary();
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_PrintDictionarySort)->Apply([](benchmark::internal::Benchmark *bench) {
+    for (long long rows = 1000; rows <= maxRows(); rows *= 10)
+    {
+        bench->Args({rows, 1});
+        bench->Args({rows, 2});
+    }
+})->Unit(benchmark::kMillisecond);
+
+// the views are already built, a page costs what printing twenty foods does
+static void BM_PrintDictionaryPage(benchmark::State &state)
+{
+    int rows = (int)state.range(0);
+    enterDictionary("dictionary", rows);
+    Console console;
+    RunApp app;
+    app.readFile();
+    console.script("2\n2\n20\n");
+    app.printDictionary(); // builds the view
+    for (auto _ : state)
+    {
+        console.script("2\n2\n20\n");
+        app.printDictionary();
+    }
+}
+BENCHMARK(BM_PrintDictionaryPage)->Apply(rowCounts);
+
+// foods logged since the last write, all committed in one go. MEAL_TRACKER_FSYNC picks the sync policy as in the app
+static void BM_WriteToLog(benchmark::State &state)
+{
+    int batch = (int)state.range(0);
+    enterDictionary("log", 1000);
+    enterProfile("writer", 30);
+    Console console;
+    RunApp app;
+    app.readFile();
+    app.switchUser("writer");
+    const vector<Food> &foods = syntheticFoods(1000);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (int i = 0; i < batch; i++)
+        {
+            Food food = foods[i % foods.size()];
+            app.logFood(food);
+        }
+        state.ResumeTiming();
+        app.writeToLog();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_WriteToLog)->Arg(1)->Arg(16)->Arg(256)->Unit(benchmark::kMicrosecond);
+
+static void BM_LoadDailyMacros(benchmark::State &state)
+{
+    enterDictionary("log", 1000);
+    enterProfile("daily", 30);
+    Console console;
+    RunApp app;
+    app.readFile();
+    app.switchUser("daily");
+    vector<Food> foods(syntheticFoods(1000).begin(), syntheticFoods(1000).begin() + 8);
+    for (Food &food : foods)
+        app.logFood(food);
+    app.writeToLog();
+    app.writeDayFiles();
+    for (auto _ : state)
+        app.loadDailyMacros();
+}
+BENCHMARK(BM_LoadDailyMacros)->Unit(benchmark::kMicrosecond);
+
+// the first use of a profile reads its whole history into the averages
+static void BM_LoadProfile(benchmark::State &state)
+{
+    int days = (int)state.range(0);
+    enterDictionary("history", 1000);
+    string profile = "days" + std::to_string(days);
+    enterProfile(profile, days);
+    Console console;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        RunApp *app = new RunApp();
+        state.ResumeTiming();
+        app->switchUser(profile);
+        state.PauseTiming();
+        delete app;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * days);
+}
+BENCHMARK(BM_LoadProfile)->Apply(rowCounts)->Unit(benchmark::kMillisecond);
+
+static void BM_PrintAverages(benchmark::State &state)
+{
+    int days = (int)state.range(0);
+    enterDictionary("history", 1000);
+    string profile = "days" + std::to_string(days);
+    enterProfile(profile, days);
+    Console console;
+    RunApp app;
+    app.switchUser(profile);
+    for (auto _ : state)
+        app.printAverages();
+}
+BENCHMARK(BM_PrintAverages)->Apply(rowCounts);
+
+// RunServer() with the socket handling left to HttpServer, started once and shared by every run. Kept alive
+// connections wait in the server's poll set between requests, so two workers serve any number of clients.
+struct BenchServer
+{
+    RunApp app;
+    HttpServer server;
+    std::thread runner;
+
+    BenchServer()
+    {
+        enterDictionary("server", 1000);
+        app.readFile();
+        server.start(0, 2, [this](const HttpRequest &request) { return app.handleRequest(request); });
+        runner = std::thread([this] { server.run(); });
+    }
+    ~BenchServer()
+    {
+        server.stop();
+        runner.join();
+    }
+};
+
+static BenchServer &benchServer()
+{
+    static BenchServer server;
+    return server;
+}
+
+static int connectTo(int port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    return fd;
+}
+
+// sends one request and reads the whole response, the status code or -1
+static int roundTrip(int fd, const string &request, string &buffer)
+{
+    if (send(fd, request.data(), request.size(), 0) != (ssize_t)request.size())
+        return -1;
+    buffer.clear();
+    char chunk[4096];
+    size_t headerEnd = string::npos;
+    size_t length = 0;
+    while (true)
+    {
+        ssize_t count = recv(fd, chunk, sizeof(chunk), 0);
+        if (count <= 0)
+            return -1;
+        buffer.append(chunk, count);
+        if (headerEnd == string::npos && (headerEnd = buffer.find("\r\n\r\n")) != string::npos)
+        {
+            size_t field = buffer.find("Content-Length:");
+            length = field < headerEnd ? strtoul(buffer.c_str() + field + 15, nullptr, 10) : 0;
+        }
+        if (headerEnd != string::npos && buffer.size() >= headerEnd + 4 + length)
+            return atoi(buffer.c_str() + 9);
+    }
+}
+
+// POST /log over keep-alive connections, one per client thread, with each client's p50 and p99
+static void BM_ServerLog(benchmark::State &state)
+{
+    BenchServer &server = benchServer();
+    if (state.thread_index() == 0)
+        enterDictionary("server", 1000); // the server's RunApp works in whatever directory is current
+    const vector<Food> &foods = syntheticFoods(1000);
+    const Food &food = *std::find_if(foods.begin(), foods.end(), [](const Food &food) { return food.getGrams() != 0; });
+    string body = "{\"food\": \"" + food.getName() + "\", \"grams\": 120}";
+    string request = "POST /log HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+    int fd = connectTo(server.server.port());
+    if (fd < 0)
+    {
+        state.SkipWithError("could not connect to the server");
+        return;
+    }
+    vector<double> latencies;
+    string response;
+    for (auto _ : state)
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (roundTrip(fd, request, response) != 200)
+        {
+            state.SkipWithError(("/log failed: " + response.substr(0, 200)).c_str());
+            break;
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    close(fd);
+    state.SetItemsProcessed(state.iterations());
+    if (!latencies.empty())
+    {
+        std::sort(latencies.begin(), latencies.end());
+        state.counters["p50_us"] = benchmark::Counter(latencies[latencies.size() / 2], benchmark::Counter::kAvgThreads);
+        state.counters["p99_us"] = benchmark::Counter(latencies[latencies.size() * 99 / 100], benchmark::Counter::kAvgThreads);
+    }
+}
+BENCHMARK(BM_ServerLog)->Threads(1)->Threads(4)->Threads(8)->UseRealTime()->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,305 @@
+//
+//  Workload.cpp
+//  Meal Tracker
+//
+
+#include "Workload.hpp"
+#include "MealTracker.hpp"
+#include "Dates.hpp"
+#include <cmath>
+#include <fstream>
+#include <numeric>
+
+using std::ofstream;
+
+struct BaseFood
+{
+    const char *name;
+    double protein, carbs, fat; // per 100 grams
+    int grams; // a usual portion
+};
+
+static const BaseFood BASES[] = {
+    {"Chicken Breast", 31, 0, 3.6, 150}, {"Chicken Thighs", 26, 0, 11, 140}, {"Ground Turkey", 27, 0, 8, 112},
+    {"Salmon", 22, 0, 13, 120}, {"Tuna", 26, 0, 1, 85}, {"Shrimp", 24, 0.2, 0.3, 100},
+    {"Steak", 26, 0, 15, 170}, {"Ground Beef", 26, 0, 17, 112}, {"Pork Chop", 27, 0, 9, 150},
+    {"Bacon", 37, 1.4, 42, 30}, {"Turkey Bacon", 30, 3, 15, 30}, {"Egg Whites", 11, 0.7, 0.2, 100},
+    {"Eggs", 13, 1.1, 11, 100}, {"Greek Yogurt", 10, 3.6, 0.4, 170}, {"Cottage Cheese", 11, 3.4, 4.3, 113},
+    {"Mozzarella Cheese", 22, 2.2, 22, 28}, {"Cheddar Cheese", 25, 1.3, 33, 28}, {"Milk", 3.4, 5, 1, 240},
+    {"Almond Milk", 0.4, 0.3, 1.1, 240}, {"Whey Protein Shake", 75, 8, 5, 33}, {"Protein Bar", 33, 40, 15, 60},
+    {"Oats", 13, 68, 6.5, 40}, {"Granola", 10, 64, 20, 50}, {"Cereal", 7, 84, 2, 30},
+    {"White Rice", 2.7, 28, 0.3, 200}, {"Brown Rice", 2.6, 23, 0.9, 200}, {"Spanish Style Rice", 2.8, 28, 2, 250},
+    {"Pasta", 5.8, 31, 0.9, 200}, {"Bagel", 10, 50, 1.7, 100}, {"Bread", 9, 49, 3.2, 50},
+    {"Tortilla", 8, 50, 7, 45}, {"Pizza", 11, 33, 10, 110}, {"Burrito", 9, 24, 8, 300},
+    {"Sandwich", 12, 28, 9, 220}, {"Potatoes", 2, 17, 0.1, 200}, {"Sweet Potato", 1.6, 20, 0.1, 150},
+    {"Tater Tots", 2.4, 26, 12, 85}, {"French Fries", 3.4, 41, 15, 117}, {"Broccoli", 2.8, 7, 0.4, 90},
+    {"Spinach", 2.9, 3.6, 0.4, 30}, {"Salad Mix", 1.3, 3.3, 0.2, 85}, {"Green Beans", 1.8, 7, 0.2, 100},
+    {"Avocado", 2, 8.5, 15, 50}, {"Apples", 0.3, 14, 0.2, 180}, {"Banana", 1.1, 23, 0.3, 118},
+    {"Red Grapes", 0.7, 18, 0.2, 150}, {"Strawberries", 0.7, 7.7, 0.3, 150}, {"Blueberries", 0.7, 14, 0.3, 140},
+    {"Orange", 0.9, 12, 0.1, 130}, {"Almonds", 21, 22, 50, 28}, {"Peanut Butter", 25, 20, 50, 32},
+    {"Black Olives", 0.8, 6, 11, 15}, {"Hummus", 8, 14, 10, 60}, {"Tofu", 8, 1.9, 4.8, 120},
+    {"Black Beans", 8.9, 24, 0.5, 130}, {"Lentil Soup", 3.6, 10, 1.3, 245}, {"Chili", 9, 10, 6, 250},
+    {"Steak Tips", 24, 8, 7, 88}, {"Salmon Patty", 18, 2, 9, 90}, {"Ice Cream", 3.5, 24, 11, 66},
+    {"Dark Chocolate", 7.8, 46, 43, 28}, {"Gatorade", 0, 6, 0, 591}, {"Orange Juice", 0.7, 10, 0.2, 240},
+    {"Cheese Bread", 11, 36, 14, 45}, {"Cookies", 5, 65, 22, 30}, {"Chips", 6.6, 53, 34, 28},
+};
+static const int BASE_COUNT = sizeof(BASES) / sizeof(BASES[0]);
+
+struct Modifier
+{
+    const char *name;
+    double protein, carbs, fat; // multiplies the base food's
+};
+
+static const Modifier MODIFIERS[] = {
+    {"", 1, 1, 1}, {"Nonfat", 1.05, 1, 0.1}, {"Low Fat", 1.05, 1, 0.5}, {"Organic", 1, 1, 1},
+    {"Grilled", 1.05, 1, 1.1}, {"Fried", 0.95, 1.25, 1.8}, {"Baked", 1, 1, 0.9}, {"Roasted", 1.02, 1, 1.05},
+    {"Smoked", 1.05, 1, 1}, {"Whole Wheat", 1.1, 0.95, 1.1}, {"Low Carb", 1.2, 0.5, 1.1}, {"High Protein", 1.4, 0.9, 1},
+    {"Light", 0.9, 0.8, 0.6}, {"Spicy", 1, 1.05, 1}, {"Honey", 1, 1.2, 1}, {"Frozen", 1, 1.05, 1.05},
+    {"Fresh", 1, 1, 1}, {"Sugar Free", 1, 0.6, 1}, {"Keto", 1.1, 0.3, 1.3}, {"Homemade", 1, 1.05, 1.15},
+};
+static const int MODIFIER_COUNT = sizeof(MODIFIERS) / sizeof(MODIFIERS[0]);
+
+static const char *BRANDS[] = {
+    "", "Costco", "Kirkland", "Trader Joe's", "Great Value", "Tyson", "Chobani", "Fage", "Quaker", "Kellogg's",
+    "Dave's Killer", "Ben's Original", "Beyond", "Tillamook", "Oikos", "Siggi's", "Nature Valley", "Clif",
+    "Starbucks", "Chipotle", "Subway", "Panera", "365", "Simple Truth", "Good & Gather", "Signature Select",
+    "Kroger", "Safeway", "Annie's", "Amy's",
+};
+static const int BRAND_COUNT = sizeof(BRANDS) / sizeof(BRANDS[0]);
+
+static const char *FLAVORS[] = {
+    "", "Vanilla", "Chocolate", "Strawberry", "Original", "Garlic", "BBQ", "Lemon Pepper", "Teriyaki", "Cinnamon",
+    "Blueberry", "Peanut Butter", "Salted", "Unsalted", "Plain", "Mixed Berry", "Sea Salt", "Chipotle", "Maple",
+    "Everything",
+};
+static const int FLAVOR_COUNT = sizeof(FLAVORS) / sizeof(FLAVORS[0]);
+
+// how many days have this many meals, and meals this many foods, going by the sample FoodLog.txt
+static const int MEALS_PER_DAY[] = {0, 3, 4, 5, 7, 5, 4, 1, 1};
+static const int FOODS_PER_MEAL[] = {0, 30, 20, 20, 15, 10, 5};
+static const int FAVORITES = 300;
+
+static uint64_t splitmix(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// 0 up to but not including 1
+static double unit(uint64_t draw)
+{
+    return (double)(draw >> 11) / (double)(1ULL << 53);
+}
+
+static int weighted(const int *weights, int count, uint64_t draw)
+{
+    int total = std::accumulate(weights, weights + count, 0);
+    int pick = (int)(draw % (uint64_t)total);
+    for (int k = 0; k < count; k++)
+    {
+        if (pick < weights[k])
+            return k;
+        pick -= weights[k];
+    }
+    return count - 1;
+}
+
+static double tenths(double value)
+{
+    return round(value * 10.0) / 10.0;
+}
+
+static string ctimeText(time_t when)
+{
+    struct tm local;
+    localtime_r(&when, &local);
+    char date[32];
+    strftime(date, sizeof(date), "%a %b %e %H:%M:%S %Y", &local);
+    return date;
+}
+
+static time_t midnight(int epochDay)
+{
+    int year = 0, month = 0, day = 0;
+    sscanf(isoDate(epochDay).c_str(), "%d-%d-%d", &year, &month, &day);
+    return startOfDay(year, month, day);
+}
+
+Workload::Workload(const WorkloadOptions &options)
+{
+    mOptions = options;
+    if (mOptions.foods < 1)
+        mOptions.foods = 1;
+    if (mOptions.lastDay < 0)
+        mOptions.lastDay = epochDayToday() - 1;
+    uint64_t size = (uint64_t)mOptions.foods;
+    mStride = size == 1 ? 1 : 2654435761ULL % size;
+    while (mStride == 0 || std::gcd(mStride, size) != 1)
+        mStride++;
+}
+
+Workload::~Workload()
+{
+
+}
+
+uint64_t Workload::hash(uint64_t a, uint64_t b) const
+{
+    return splitmix(splitmix(mOptions.seed ^ splitmix(a)) ^ b);
+}
+
+int Workload::spread(int i) const
+{
+    return (int)(((uint64_t)i * mStride) % (uint64_t)mOptions.foods);
+}
+
+int Workload::favorite(uint64_t draw) const
+{
+    // seven in ten from a few hundred regulars, Zipf with s = 0.8 so the top one is about 6% of everything
+    // eaten, the rest from anywhere in the dictionary with low ranks still likelier
+    double u = unit(hash(draw, 5)), rank = 0.0;
+    if (unit(draw) < 0.7)
+        rank = pow((pow(FAVORITES + 1.0, 0.2) - 1.0) * u + 1.0, 5.0) - 1.0;
+    else
+        rank = exp(u * log((double)mOptions.foods)) - 1.0;
+    int row = std::min((int)rank, mOptions.foods - 1);
+    return (int)(((uint64_t)row * mStride + mOptions.seed) % (uint64_t)mOptions.foods);
+}
+
+string Workload::foodName(int i) const
+{
+    // the name number picks base food first, then modifier, brand and flavor, and past those a pack size
+    int n = spread(i);
+    const BaseFood &base = BASES[n % BASE_COUNT];
+    n /= BASE_COUNT;
+    const char *modifier = MODIFIERS[n % MODIFIER_COUNT].name;
+    n /= MODIFIER_COUNT;
+    const char *brand = BRANDS[n % BRAND_COUNT];
+    n /= BRAND_COUNT;
+    const char *flavor = FLAVORS[n % FLAVOR_COUNT];
+    n /= FLAVOR_COUNT;
+
+    string name;
+    for (const char *word : {brand, modifier, base.name, flavor})
+    {
+        if (*word == '\0')
+            continue;
+        if (!name.empty())
+            name += ' ';
+        name += word;
+    }
+    if (n > 0)
+    {
+        name += ' ';
+        name += std::to_string(n + 1);
+        name += " Pack";
+    }
+    return name;
+}
+
+Food Workload::food(int i) const
+{
+    int n = spread(i);
+    const BaseFood &base = BASES[n % BASE_COUNT];
+    const Modifier &modifier = MODIFIERS[(n / BASE_COUNT) % MODIFIER_COUNT];
+    uint64_t draw = hash((uint64_t)i, 1);
+
+    int grams = std::max(1, (int)round(base.grams * (0.75 + 0.5 * unit(draw))));
+    double scale = grams / 100.0;
+    double protein = tenths(base.protein * modifier.protein * (0.85 + 0.3 * unit(hash(draw, 2))) * scale);
+    double carbs = tenths(base.carbs * modifier.carbs * (0.85 + 0.3 * unit(hash(draw, 3))) * scale);
+    double fat = tenths(base.fat * modifier.fat * (0.85 + 0.3 * unit(hash(draw, 4))) * scale);
+    int calories = (int)round(4 * protein + 4 * carbs + 9 * fat);
+    // two in five are packaged foods listed by the serving
+    bool byServings = draw % 5 < 2;
+    return Food(foodName(i), byServings ? 0 : grams, byServings ? 1 : 0, calories, protein, carbs, fat);
+}
+
+bool Workload::writeFoodData(const string &path)
+{
+    ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out.is_open())
+        return false;
+    for (int i = 0; i < mOptions.foods; i++)
+    {
+        Food row = food(i);
+        out << row.getName() << "," << row.getGrams() << "," << row.getServings() << "," << row.getCal() << "," << row.getProtein() << "," << row.getCarb() << "," << row.getFat() << "\n";
+    }
+    mCounts.foods = mOptions.foods;
+    return out.good();
+}
+
+bool Workload::writeLogs(const string &foodLogPath, const string &macrosLogPath)
+{
+    ofstream foodLog(foodLogPath, std::ios::out | std::ios::trunc);
+    ofstream macrosLog(macrosLogPath, std::ios::out | std::ios::trunc);
+    if (!foodLog.is_open() || !macrosLog.is_open())
+        return false;
+
+    mCounts.days = mCounts.meals = mCounts.eaten = 0;
+    for (int day = mOptions.lastDay - mOptions.days + 1; day <= mOptions.lastDay; day++)
+    {
+        uint64_t dayDraw = hash((uint64_t)day, 2);
+        if (unit(dayDraw) < mOptions.skippedDays)
+            continue;
+        time_t start = midnight(day);
+        if (start == (time_t)-1)
+            continue;
+
+        // meals spread from seven in the morning to half past ten at night
+        int meals = weighted(MEALS_PER_DAY, sizeof(MEALS_PER_DAY) / sizeof(MEALS_PER_DAY[0]), hash(dayDraw, 3));
+        int slot = (15 * 3600 + 1800) / meals;
+        int calories = 0;
+        double protein = 0.0, carbs = 0.0, fat = 0.0;
+        time_t when = start;
+        for (int meal = 0; meal < meals; meal++)
+        {
+            uint64_t mealDraw = hash(dayDraw, 16 + (uint64_t)meal);
+            when = start + 7 * 3600 + meal * slot + (time_t)(mealDraw % (uint64_t)std::max(slot - 60, 1));
+            foodLog << "Date: " << ctimeText(when) << "\n";
+            int foods = weighted(FOODS_PER_MEAL, sizeof(FOODS_PER_MEAL) / sizeof(FOODS_PER_MEAL[0]), mealDraw >> 8);
+            for (int k = 0; k < foods; k++)
+            {
+                uint64_t draw = hash(mealDraw, 64 + (uint64_t)k);
+                Food listed = food(favorite(draw));
+                double grams = 0.0, servings = 0.0;
+                if (listed.getGrams() != 0)
+                    grams = round(listed.getGrams() * (0.5 + 1.5 * unit(hash(draw, 1))));
+                else
+                    servings = unit(hash(draw, 1)) < 0.7 ? 1 : unit(hash(draw, 2)) < 0.8 ? 2 : 3;
+                Food eaten = MealTracker::portion(listed, grams, servings);
+                foodLog << eaten << "\n";
+                calories += eaten.getCal();
+                protein += eaten.getProtein();
+                carbs += eaten.getCarb();
+                fat += eaten.getFat();
+                mCounts.eaten++;
+            }
+            foodLog << "Todays Totals:" << "\n" << "Calories:" << calories << "  Protein:" << round(protein) << "  Carbs:" << round(carbs) << "  Fats:" << round(fat) << "\n";
+            foodLog << "----------------------------------------------------------------------------------" << "\n";
+            mCounts.meals++;
+        }
+        // the day is closed at its last meal
+        macrosLog << "Date-" << ctimeText(when) << "\n";
+        macrosLog << "Calories:" << calories << "  Protein:" << round(protein) << "  Carbs:" << round(carbs) << "  Fats:" << round(fat) << "\n";
+        mCounts.days++;
+    }
+    return foodLog.good() && macrosLog.good();
+}
+
+bool Workload::writeGoals(const string &path)
+{
+    ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out.is_open())
+        return false;
+    out << "2000,150,250,70";
+    return out.good();
+}
+
+const WorkloadCounts &Workload::counts() const
+{
+    return mCounts;
+}
@@ -0,0 +1,73 @@
+//
+//  Workload.hpp
+//  Meal Tracker
+//
+//  Writes a made up FoodData.csv, FoodLog.txt and MacrosLog.txt in the
+//  formats the app reads, at any size, to load test against. Everything
+//  comes from the seed, the same options give the same bytes (apart from
+//  the time zone, dates are local like the app's).
+//
+//  Foods are put together from a list of real base foods, modifiers
+//  ("Nonfat", "Grilled"), brands and flavors, with macros from the base
+//  food per 100 grams adjusted by the modifier and a little noise. About
+//  two in five are listed by servings. Food i can be made on its own
+//  without the rest, so a 10M food dictionary is written a row at a time.
+//
+//  The log is one person eating: a few meals a day, a few foods a meal,
+//  picked mostly from a few hundred favorites (Zipf-like) and otherwise from
+//  anywhere in the dictionary, with the odd day not logged. Every logged day
+//  ends up in MacrosLog.txt with its totals, like closing the day in the app
+//  would.
+//
+
+#ifndef Workload_hpp
+#define Workload_hpp
+#include "Food.hpp"
+#include <string>
+#include <cstdint>
+#include <stdio.h>
+
+using std::string;
+
+struct WorkloadOptions
+{
+    int foods = 100000;
+    int days = 365 * 20;
+    int lastDay = -1; // epoch day of the last logged day, yesterday when -1
+    uint64_t seed = 42;
+    double skippedDays = 0.05; // share of days with nothing logged
+};
+
+struct WorkloadCounts
+{
+    long long foods = 0; // dictionary rows
+    long long days = 0; // days in MacrosLog.txt
+    long long meals = 0; // blocks in FoodLog.txt
+    long long eaten = 0; // foods in FoodLog.txt
+};
+
+class Workload
+{
+public:
+    Workload(const WorkloadOptions &options);
+    ~Workload();
+
+    string foodName(int i) const; // different for every i below the dictionary size
+    Food food(int i) const; // dictionary row i
+
+    bool writeFoodData(const string &path); // false if the file can't be written
+    bool writeLogs(const string &foodLogPath, const string &macrosLogPath); // both at once, MacrosLog.txt holds FoodLog.txt's day totals
+    bool writeGoals(const string &path); // a MacroGoals.txt so the app doesn't ask
+    const WorkloadCounts &counts() const;
+
+private:
+    uint64_t hash(uint64_t a, uint64_t b) const; // the seed mixed with a and b
+    int spread(int i) const; // dictionary row -> name number, a bijection so neighbours don't look alike
+    int favorite(uint64_t draw) const; // a dictionary row, low ranks far more often than high ones
+
+    WorkloadOptions mOptions;
+    WorkloadCounts mCounts;
+    uint64_t mStride; // coprime with the dictionary size
+};
+
+#endif /* Workload_hpp */
@@ -0,0 +1,57 @@
+//
+//  AllocationCounter.cpp
+//  Meal Tracker
+//
+//  Replaces operator new so SessionStats can count heap allocations. Only
+//  linked into a program that asks for it (MEAL_TRACKER_COUNT_ALLOCATIONS in
+//  CMake), never part of libmealtracker, so linking the library leaves the
+//  allocator alone. Without it allocationCount() stays 0. Even linked in it
+//  only counts while MEAL_TRACKER_STATS or MEAL_TRACKER_TRACE is set.
+//
+
+#include "SessionStats.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint64_t> gAllocations(0);
+
+// the array, nothrow and sized forms all end up in these. Kept out of line, gcc takes free() inlined
+// into map code for a mismatch with new
+void *operator new(size_t size)
+{
+    if (gTracing)
+        gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0)
+        size = 1;
+    while (true)
+    {
+        void *memory = malloc(size);
+        if (memory != nullptr)
+            return memory;
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+__attribute__((noinline)) void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+__attribute__((noinline)) void operator delete(void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+bool allocationsCounted()
+{
+    return true;
+}
+
+uint64_t allocationCount()
+{
+    return gAllocations.load(std::memory_order_relaxed);
+}
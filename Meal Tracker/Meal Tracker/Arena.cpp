@@ -0,0 +1,114 @@
+//
+//  Arena.cpp
+//  Meal Tracker
+//
+
+#include "Arena.hpp"
+#include <cstdint>
+#include <new>
+
+Arena::Arena(size_t blockSize)
+{
+    mBlockSize = blockSize;
+    mFirst = nullptr;
+    mCurrent = nullptr;
+    mOffset = 0;
+    mUsed = 0;
+}
+
+Arena::~Arena()
+{
+    Block *block = mFirst;
+    while (block != nullptr)
+    {
+        Block *next = block->next;
+        ::operator delete(block);
+        block = next;
+    }
+}
+
+char *Arena::start(Block *block) const
+{
+    return reinterpret_cast<char *>(block) + sizeof(Block);
+}
+
+void *Arena::allocate(size_t bytes, size_t alignment)
+{
+    while (true)
+    {
+        if (mCurrent != nullptr)
+        {
+            uintptr_t at = reinterpret_cast<uintptr_t>(start(mCurrent)) + mOffset;
+            size_t padding = (alignment - at % alignment) % alignment;
+            if (mOffset + padding + bytes <= mCurrent->size)
+            {
+                mOffset += padding + bytes;
+                mUsed += bytes;
+                return reinterpret_cast<void *>(at + padding);
+            }
+            if (mCurrent->next != nullptr && mCurrent->next->size >= bytes + alignment)
+            {
+                // a block kept from before the last release
+                mCurrent = mCurrent->next;
+                mOffset = 0;
+                continue;
+            }
+        }
+
+        size_t size = bytes + alignment > mBlockSize ? bytes + alignment : mBlockSize;
+        // from operator new rather than malloc so the session's allocation count sees it
+        Block *block = static_cast<Block *>(::operator new(sizeof(Block) + size));
+        block->size = size;
+        if (mCurrent == nullptr)
+        {
+            block->next = mFirst;
+            mFirst = block;
+        }
+        else
+        {
+            block->next = mCurrent->next;
+            mCurrent->next = block;
+        }
+        mCurrent = block;
+        mOffset = 0;
+    }
+}
+
+void Arena::release()
+{
+    if (mFirst == nullptr)
+        return;
+    // the first block stays for the next round, the rest go back in one pass
+    Block *block = mFirst->next;
+    while (block != nullptr)
+    {
+        Block *next = block->next;
+        ::operator delete(block);
+        block = next;
+    }
+    mFirst->next = nullptr;
+    mCurrent = mFirst;
+    mOffset = 0;
+    mUsed = 0;
+}
+
+size_t Arena::bytesUsed() const
+{
+    return mUsed;
+}
+
+size_t Arena::bytesReserved() const
+{
+    size_t total = 0;
+    for (Block *block = mFirst; block != nullptr; block = block->next)
+        total += sizeof(Block) + block->size;
+    return total;
+}
+
+int Arena::blockCount() const
+{
+    int count = 0;
+    for (Block *block = mFirst; block != nullptr; block = block->next)
+        count++;
+    return count;
+}
@@ -0,0 +1,50 @@
+//
+//  Arena.hpp
+//  Meal Tracker
+//
+//  A monotonic allocator: memory is handed out by bumping a pointer through
+//  big blocks and is never given back one piece at a time. Everything goes
+//  at once with release(), which keeps the first block for the next round
+//  so a new day of logging starts without asking the heap for anything.
+//
+
+#ifndef Arena_hpp
+#define Arena_hpp
+#include <cstddef>
+#include <stdio.h>
+
+class Arena
+{
+public:
+    Arena(size_t blockSize = 64 * 1024);
+    ~Arena();
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+    template <typename T> T *allocateArray(size_t count)
+    {
+        return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+    }
+    void release();
+
+    size_t bytesUsed() const; // handed out since the last release
+    size_t bytesReserved() const; // held in blocks
+    int blockCount() const;
+
+private:
+    struct Block
+    {
+        Block *next;
+        size_t size; // usable bytes after the header
+    };
+    char *start(Block *block) const;
+
+    size_t mBlockSize;
+    Block *mFirst;
+    Block *mCurrent;
+    size_t mOffset; // into mCurrent
+    size_t mUsed;
+};
+
+#endif /* Arena_hpp */
@@ -0,0 +1,124 @@
+//
+//  Dates.cpp
+//  Meal Tracker
+//
+
+#include "Dates.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+static std::atomic<time_t> gFakeTime(0);
+
+// Howard Hinnant's days_from_civil
+int epochDayFromCivil(int year, int month, int day)
+{
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = (unsigned)(year - era * 400);
+    const unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + (int)dayOfEra - 719468;
+}
+
+time_t startOfDay(int year, int month, int day)
+{
+    struct tm local;
+    memset(&local, 0, sizeof(local));
+    local.tm_year = year - 1900;
+    local.tm_mon = month - 1;
+    local.tm_mday = day;
+    local.tm_isdst = -1;
+    time_t midnight = mktime(&local);
+    if (midnight == (time_t)-1 || local.tm_mday != day)
+        return -1; // the 31st of a 30 day month and the like
+    return midnight;
+}
+
+time_t currentTime()
+{
+    time_t fake = gFakeTime.load(std::memory_order_relaxed);
+    return fake != 0 ? fake : time(0);
+}
+
+void setCurrentTime(time_t when)
+{
+    gFakeTime.store(when, std::memory_order_relaxed);
+}
+
+int epochDay(time_t when)
+{
+    struct tm local;
+    localtime_r(&when, &local);
+    return epochDayFromCivil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+}
+
+int epochDayToday()
+{
+    return epochDay(currentTime());
+}
+
+time_t noonOf(int epochDay)
+{
+    struct tm local;
+    memset(&local, 0, sizeof(local));
+    local.tm_year = 70;
+    local.tm_mday = 1 + epochDay; // mktime carries the days over into months and years
+    local.tm_hour = 12;
+    local.tm_isdst = -1;
+    return mktime(&local);
+}
+
+int epochDayFromCtime(const string &text)
+{
+    static const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    for (size_t start = 0; start + 24 <= text.size(); start++)
+    {
+        // "Www Mmm dd hh:mm:ss yyyy"
+        const char *p = text.c_str() + start;
+        if (p[3] != ' ' || p[7] != ' ' || p[10] != ' ' || p[13] != ':' || p[16] != ':' || p[19] != ' ')
+            continue;
+        int month = -1;
+        for (int m = 0; m < 12; m++)
+        {
+            if (strncmp(p + 4, months[m], 3) == 0)
+                month = m + 1;
+        }
+        if (month == -1)
+            continue;
+        int day = atoi(p + 8);
+        int year = atoi(p + 20);
+        if (day < 1 || day > 31 || year < 1900)
+            continue;
+        return epochDayFromCivil(year, month, day);
+    }
+    return -1;
+}
+
+int epochDayFromIso(const string &text)
+{
+    int year = 0, month = 0, day = 0;
+    if (sscanf(text.c_str(), "%d-%d-%d", &year, &month, &day) != 3)
+        return -1;
+    if (month < 1 || month > 12 || day < 1 || day > 31)
+        return -1;
+    return epochDayFromCivil(year, month, day);
+}
+
+// Howard Hinnant's civil_from_days
+string isoDate(int epochDay)
+{
+    int z = epochDay + 719468;
+    const int era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned dayOfEra = (unsigned)(z - era * 146097);
+    const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int year = (int)yearOfEra + era * 400;
+    const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const unsigned mp = (5 * dayOfYear + 2) / 153;
+    const unsigned day = dayOfYear - (153 * mp + 2) / 5 + 1;
+    const unsigned month = mp < 10 ? mp + 3 : mp - 9;
+
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%04d-%02u-%02u", year + (month <= 2), month, day);
+    return buffer;
+}
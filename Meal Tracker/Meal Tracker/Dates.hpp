@@ -0,0 +1,29 @@
+//
+//  Dates.hpp
+//  Meal Tracker
+//
+//  Days are counted as "epoch days", the number of local calendar days since
+//  1/1/1970. Two times are on the same day when their epoch days match, no
+//  more comparing the first characters of ctime() output.
+//
+
+#ifndef Dates_hpp
+#define Dates_hpp
+#include <string>
+#include <ctime>
+#include <stdio.h>
+
+using std::string;
+
+time_t currentTime(); // time(0), unless a test set the clock
+void setCurrentTime(time_t when); // for tests, the clock stays at when until it is set again, 0 puts the real one back
+int epochDay(time_t when); // local calendar day that when falls on
+int epochDayToday();
+time_t noonOf(int epochDay); // local noon, a time that is surely on that day whatever daylight saving does
+int epochDayFromCivil(int year, int month, int day); // month 1-12
+time_t startOfDay(int year, int month, int day); // local midnight, -1 for a date that doesn't exist
+int epochDayFromCtime(const string &text); // finds a ctime() style date like "Tue Apr  8 09:52:41 2025" in text, -1 if there is none
+int epochDayFromIso(const string &text); // "2025-04-08", -1 if it doesn't parse
+string isoDate(int epochDay);
+
+#endif /* Dates_hpp */
@@ -0,0 +1,142 @@
+//
+//  DictionaryViews.cpp
+//  Meal Tracker
+//
+
+#include "DictionaryViews.hpp"
+#include <algorithm>
+#include <numeric>
+#include <string>
+
+using std::string;
+
+static double numericKey(SortKey key, const Food &food)
+{
+    switch (key)
+    {
+        case BY_CALORIES: return food.getCal();
+        case BY_PROTEIN: return food.getProtein();
+        case BY_CARBS: return food.getCarb();
+        case BY_FATS: return food.getFat();
+        default: return 0.0;
+    }
+}
+
+DictionaryViews::DictionaryViews()
+{
+    clear();
+}
+
+DictionaryViews::~DictionaryViews()
+{
+
+}
+
+void DictionaryViews::clear()
+{
+    for (int key = 0; key < KEY_COUNT; key++)
+    {
+        mOrders[key].clear();
+        mBuilt[key] = false;
+    }
+}
+
+bool DictionaryViews::comesBefore(SortKey key, const Food &a, int aPosition, const Food &b, int bPosition)
+{
+    if (key == BY_NAME)
+    {
+        int compared = a.getName().compare(b.getName());
+        if (compared != 0)
+            return compared < 0;
+    }
+    else
+    {
+        double aKey = numericKey(key, a), bKey = numericKey(key, b);
+        if (aKey != bKey)
+            return aKey < bKey;
+    }
+    return aPosition < bPosition;
+}
+
+// Sorts a view once, pulling the keys out first so the sort doesn't go through the getters every compare
+void DictionaryViews::build(const vector<Food> &foods, SortKey key)
+{
+    vector<int> &order = mOrders[key];
+    order.resize(foods.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (key == BY_NAME)
+    {
+        vector<string> names;
+        names.reserve(foods.size());
+        for (auto i = foods.begin(); i != foods.end(); ++i)
+            names.push_back(i->getName());
+        std::sort(order.begin(), order.end(), [&names](int a, int b) {
+            int compared = names[a].compare(names[b]);
+            return compared != 0 ? compared < 0 : a < b;
+        });
+    }
+    else
+    {
+        vector<double> keys;
+        keys.reserve(foods.size());
+        for (auto i = foods.begin(); i != foods.end(); ++i)
+            keys.push_back(numericKey(key, *i));
+        std::sort(order.begin(), order.end(), [&keys](int a, int b) {
+            return keys[a] != keys[b] ? keys[a] < keys[b] : a < b;
+        });
+    }
+    mBuilt[key] = true;
+}
+
+void DictionaryViews::insert(const vector<Food> &foods, int position)
+{
+    const Food &food = foods[position];
+    for (int key = 0; key < KEY_COUNT; key++)
+    {
+        if (!mBuilt[key])
+            continue;
+        vector<int> &order = mOrders[key];
+        auto at = std::lower_bound(order.begin(), order.end(), position, [&](int entry, int) {
+            return comesBefore((SortKey)key, foods[entry], entry, food, position);
+        });
+        order.insert(at, position);
+    }
+}
+
+void DictionaryViews::update(const vector<Food> &foods, int position, const Food &before)
+{
+    const Food &after = foods[position];
+    for (int key = 0; key < KEY_COUNT; key++)
+    {
+        if (!mBuilt[key])
+            continue;
+        vector<int> &order = mOrders[key];
+        // the view is still ordered by the old values, so find the entry using them
+        auto at = std::lower_bound(order.begin(), order.end(), position, [&](int entry, int) {
+            const Food &food = entry == position ? before : foods[entry];
+            return comesBefore((SortKey)key, food, entry, before, position);
+        });
+        if (at == order.end() || *at != position)
+        {
+            build(foods, (SortKey)key); // shouldn't happen, but a rebuild always gets back to a good view
+            continue;
+        }
+        order.erase(at);
+        at = std::lower_bound(order.begin(), order.end(), position, [&](int entry, int) {
+            return comesBefore((SortKey)key, foods[entry], entry, after, position);
+        });
+        order.insert(at, position);
+    }
+}
+
+vector<int> DictionaryViews::page(const vector<Food> &foods, SortKey key, int first, int count, bool highestFirst)
+{
+    if (!mBuilt[key])
+        build(foods, key);
+    const vector<int> &order = mOrders[key];
+    vector<int> positions;
+    int total = (int)order.size();
+    for (int rank = std::max(first, 0); rank < total && rank < first + count; rank++)
+        positions.push_back(highestFirst ? order[total - 1 - rank] : order[rank]);
+    return positions;
+}
@@ -0,0 +1,41 @@
+//
+//  DictionaryViews.hpp
+//  Meal Tracker
+//
+//  Sorted views of the food dictionary that never move the foods. Each view
+//  is a list of dictionary positions in key order, built the first time it
+//  is asked for and then kept in order as foods are added or edited. Every
+//  call gets the dictionary's foods as they are now.
+//
+
+#ifndef DictionaryViews_hpp
+#define DictionaryViews_hpp
+#include "Food.hpp"
+#include <vector>
+#include <stdio.h>
+
+using std::vector;
+
+enum SortKey { BY_NAME = 0, BY_CALORIES = 1, BY_PROTEIN = 2, BY_CARBS = 3, BY_FATS = 4 };
+
+class DictionaryViews
+{
+public:
+    DictionaryViews();
+    ~DictionaryViews();
+
+    void clear(); // the dictionary was reloaded, views get rebuilt when next used
+    void insert(const vector<Food> &foods, int position); // a food was appended to the dictionary at position
+    void update(const vector<Food> &foods, int position, const Food &before); // the food at position was edited, before is how it looked
+    vector<int> page(const vector<Food> &foods, SortKey key, int first, int count, bool highestFirst); // positions of the foods ranked first up to first + count
+
+private:
+    static const int KEY_COUNT = 5;
+    void build(const vector<Food> &foods, SortKey key);
+    static bool comesBefore(SortKey key, const Food &a, int aPosition, const Food &b, int bPosition);
+
+    vector<int> mOrders[KEY_COUNT]; // dictionary positions, lowest key first, ties in dictionary order
+    bool mBuilt[KEY_COUNT];
+};
+
+#endif /* DictionaryViews_hpp */
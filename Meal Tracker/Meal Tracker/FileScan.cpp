@@ -0,0 +1,97 @@
+//
+//  FileScan.cpp
+//  Meal Tracker
+//
+
+#include "FileScan.hpp"
+#include "SessionStats.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const string &path)
+{
+    countFileOpen(path);
+    mFd = open(path.c_str(), O_RDONLY);
+    if (mFd < 0)
+        return;
+    struct stat info;
+    if (fstat(mFd, &info) != 0)
+        return;
+    mSize = (size_t)info.st_size;
+    if (mSize == 0)
+        return;
+    void *data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, mFd, 0);
+    if (data == MAP_FAILED)
+    {
+        mSize = 0;
+        return;
+    }
+    mData = static_cast<const char *>(data);
+    madvise(data, mSize, MADV_SEQUENTIAL);
+    countBytesRead(mSize); // the callers go through all of it
+}
+
+MappedFile::~MappedFile()
+{
+    if (mData != nullptr)
+        munmap(const_cast<char *>(mData), mSize);
+    if (mFd >= 0)
+        close(mFd);
+}
+
+// stoi and stod skipped leading whitespace, hand edited rows like "Egg, 70, 1" still load
+static const char *skipSpaces(const char *first, const char *last)
+{
+    while (first < last && (*first == ' ' || *first == '\t'))
+        first++;
+    return first;
+}
+
+bool parseInt(const char *first, const char *last, int &value)
+{
+    // stoi used to accept "100.0" in an int column, from_chars stopping at the dot gives the same result.
+    // from_chars takes no '+', stoi did
+    first = skipSpaces(first, last);
+    if (first + 1 < last && first[0] == '+' && first[1] != '-')
+        first++;
+    return std::from_chars(first, last, value).ec == std::errc();
+}
+
+// from_chars for doubles is still missing from some standard libraries, strtod on a copy stands in there
+bool parseDouble(const char *first, const char *last, double &value)
+{
+    const char *p = skipSpaces(first, last);
+    if (p + 1 < last && p[0] == '+' && p[1] != '-')
+        p++;
+    double parsed = 0.0;
+    const char *end = p;
+#ifdef __cpp_lib_to_chars
+    std::from_chars_result result = std::from_chars(p, last, parsed);
+    if (result.ec != std::errc())
+        return false;
+    end = result.ptr;
+#else
+    char copy[64];
+    size_t length = (size_t)(last - p);
+    if (length == 0 || length >= sizeof(copy))
+        return false;
+    memcpy(copy, p, length);
+    copy[length] = '\0';
+    char *stop = copy;
+    parsed = strtod(copy, &stop);
+    if (stop == copy)
+        return false;
+    end = p + (stop - copy);
+#endif
+    // a number has to be all there is in the field, "12abc" or "1e400" is a bad row and not 12 or inf
+    if (skipSpaces(end, last) != last || !std::isfinite(parsed))
+        return false;
+    value = parsed;
+    return true;
+}
@@ -0,0 +1,41 @@
+//
+//  FileScan.hpp
+//  Meal Tracker
+//
+//  Reading text files in place: a read only mapping of the whole file and
+//  number parsers that work on a [first, last) run of characters, so rows
+//  can be picked apart without copying them into strings first.
+//
+
+#ifndef FileScan_hpp
+#define FileScan_hpp
+#include <string>
+#include <stdio.h>
+
+using std::string;
+
+// Keeps a read only mapping of a whole file alive for the scope it lives in
+class MappedFile
+{
+public:
+    MappedFile(const string &path);
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool isOpen() const { return mFd >= 0; }
+    const char *data() const { return mData; }
+    size_t size() const { return mSize; }
+
+private:
+    int mFd = -1;
+    const char *mData = nullptr;
+    size_t mSize = 0;
+};
+
+// Read the number the run starts with, false if it doesn't start with one. parseInt stops at a decimal point like stoi did
+bool parseInt(const char *first, const char *last, int &value);
+// The run has to be one finite number, spaces around it allowed, and it comes out exactly as from_chars reads it
+bool parseDouble(const char *first, const char *last, double &value);
+
+#endif /* FileScan_hpp */
@@ -6,6 +6,7 @@
 //
 
 #include "Food.hpp"
+#include <utility>
 using std::string;
 
 Food::Food()
@@ -19,6 +20,12 @@ Food::Food()
     mServings = 0;
 }
 
+Food::Food(string name, int grams, int servings, int cal, double protein, double carb, double fat)
+    : mName(std::move(name)), mGrams(grams), mCal(cal), mFat(fat), mCarb(carb), mProtein(protein), mServings(servings)
+{
+    
+}
+
 Food::~Food()
 {
     
@@ -35,44 +42,51 @@ Food::Food(const Food &copy)
     mServings = copy.mServings;
 }
 
-string Food::getName()
+// moving only hands over the name's buffer, the dictionary copies and vectors of foods lean on this
+Food::Food(Food &&other) noexcept
+    : mName(std::move(other.mName)), mGrams(other.mGrams), mCal(other.mCal), mFat(other.mFat), mCarb(other.mCarb), mProtein(other.mProtein), mServings(other.mServings)
+{
+
+}
+
+const string &Food::getName() const
 {
     return mName;
 }
 
-int Food::getGrams()
+int Food::getGrams() const
 {
     return mGrams;
 }
 
-int Food::getCal()
+int Food::getCal() const
 {
     return mCal;
 }
 
-double Food::getFat()
+double Food::getFat() const
 {
     return mFat;
 }
 
-double Food::getCarb()
+double Food::getCarb() const
 {
     return mCarb;
 }
 
-double Food::getProtein()
+double Food::getProtein() const
 {
     return mProtein;
 }
 
-int Food::getServings()
+int Food::getServings() const
 {
     return mServings;
 }
 
 void Food::setName(string newName)
 {
-    mName = newName;
+    mName = std::move(newName);
 }
 
 void Food::setGrams(int newGram)
@@ -121,3 +135,18 @@ Food& Food::operator=( const Food &obj)
     }
     return *this;
 }
+
+Food& Food::operator=(Food &&obj) noexcept
+{
+    if (this != &obj)
+    {
+        mName = std::move(obj.mName);
+        mGrams = obj.mGrams;
+        mCal = obj.mCal;
+        mFat = obj.mFat;
+        mCarb = obj.mCarb;
+        mProtein = obj.mProtein;
+        mServings = obj.mServings;
+    }
+    return *this;
+}
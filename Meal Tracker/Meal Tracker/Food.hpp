@@ -23,17 +23,19 @@ class Food
 {
 public:
     Food();
+    Food(string name, int grams, int servings, int cal, double protein, double carb, double fat);
     ~Food();
     Food(const Food &copy);
+    Food(Food &&other) noexcept;
     
     //write getters and setters here and add it to the run app load list function 10/8/23
-    string getName();
-    int getGrams();
-    int getCal();
-    double getFat();
-    double getCarb();
-    double getProtein();
-    int getServings();
+    const string &getName() const;
+    int getGrams() const;
+    int getCal() const;
+    double getFat() const;
+    double getCarb() const;
+    double getProtein() const;
+    int getServings() const;
     
     void setName(string newName);
     void setGrams(int newGrams);
@@ -44,6 +46,7 @@ public:
     void setServings(int newServing);
     
     Food & operator=(const Food &obj);
+    Food & operator=(Food &&obj) noexcept;
     
     friend std::ostream& operator<<(std::ostream& os, const Food& obj) {
         os <<  obj.mName << std::endl
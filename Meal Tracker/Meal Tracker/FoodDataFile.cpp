@@ -0,0 +1,206 @@
+//
+//  FoodDataFile.cpp
+//  Meal Tracker
+//
+
+#include "FoodDataFile.hpp"
+#include "SessionStats.hpp"
+#include "FileScan.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <sys/stat.h>
+
+// Splits one csv row into its seven fields, false if the row doesn't have all of them
+static bool splitRow(const char *first, const char *last, const char *fields[8])
+{
+    fields[0] = first;
+    int count = 1;
+    for (const char *p = first; p < last && count < 7; p++)
+    {
+        if (*p == ',')
+            fields[count++] = p + 1;
+    }
+    fields[7] = last + 1; // as if there was one more comma at the end of the row
+    return count == 7;
+}
+
+int loadFoodDataCsv(const string &path, vector<Food> &foods)
+{
+    ScopedTimer timer("loadFoodDataCsv");
+    MappedFile file(path);
+    if (!file.isOpen())
+        return -1;
+    if (file.size() == 0)
+        return 0;
+
+    const char *data = file.data();
+    const char *end = data + file.size();
+    foods.reserve(foods.size() + std::count(data, end, '\n') + 1);
+
+    int added = 0;
+    const char *line = data;
+    while (line < end)
+    {
+        const char *lineEnd = static_cast<const char *>(memchr(line, '\n', end - line));
+        if (lineEnd == nullptr)
+            lineEnd = end;
+        const char *next = lineEnd + 1;
+        if (lineEnd > line && lineEnd[-1] == '\r')
+            lineEnd--;
+
+        const char *fields[8];
+        int grams = 0, servings = 0, calories = 0;
+        double protein = 0.0, carbs = 0.0, fat = 0.0;
+        if (lineEnd > line && splitRow(line, lineEnd, fields)
+            && parseInt(fields[1], fields[2] - 1, grams)
+            && parseInt(fields[2], fields[3] - 1, servings)
+            && parseInt(fields[3], fields[4] - 1, calories)
+            && parseDouble(fields[4], fields[5] - 1, protein)
+            && parseDouble(fields[5], fields[6] - 1, carbs)
+            && parseDouble(fields[6], fields[7] - 1, fat))
+        {
+            foods.emplace_back(string(fields[0], fields[1] - 1), grams, servings, calories, protein, carbs, fat);
+            added++;
+        }
+        line = next;
+    }
+    return added;
+}
+
+// Snapshot layout: header, one fixed size record per food, then all the names back to back
+static const char SNAPSHOT_MAGIC[4] = {'M', 'T', 'F', 'D'};
+static const uint32_t SNAPSHOT_VERSION = 3; // 2 added the csv's size and modification time, 3 is read with the exact parseDouble
+
+struct SnapshotHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+    uint64_t nameBytes;
+    int64_t csvSize;
+    int64_t csvModified;
+};
+
+struct SnapshotRecord
+{
+    uint64_t nameOffset;
+    uint32_t nameLength;
+    int32_t grams;
+    int32_t servings;
+    int32_t calories;
+    double protein;
+    double carbs;
+    double fat;
+};
+
+int loadFoodDataSnapshot(const string &path, vector<Food> &foods)
+{
+    ScopedTimer timer("loadFoodDataSnapshot");
+    MappedFile file(path);
+    if (!file.isOpen() || file.size() < sizeof(SnapshotHeader))
+        return -1;
+
+    SnapshotHeader header;
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || header.version != SNAPSHOT_VERSION)
+        return -1;
+    size_t recordBytes = (size_t)header.count * sizeof(SnapshotRecord);
+    if (file.size() != sizeof(SnapshotHeader) + recordBytes + header.nameBytes)
+        return -1;
+
+    const char *records = file.data() + sizeof(SnapshotHeader);
+    const char *names = records + recordBytes;
+    foods.reserve(foods.size() + header.count);
+    for (uint64_t i = 0; i < header.count; i++)
+    {
+        SnapshotRecord record;
+        memcpy(&record, records + i * sizeof(SnapshotRecord), sizeof(record));
+        if (record.nameOffset + record.nameLength > header.nameBytes)
+            return -1;
+        foods.emplace_back(string(names + record.nameOffset, record.nameLength), record.grams, record.servings, record.calories, record.protein, record.carbs, record.fat);
+    }
+    return (int)header.count;
+}
+
+CsvStamp csvStampOf(const string &csvPath)
+{
+    CsvStamp stamp;
+    struct stat info;
+    if (stat(csvPath.c_str(), &info) != 0)
+        return stamp;
+#ifdef __APPLE__
+    const struct timespec &modified = info.st_mtimespec;
+#else
+    const struct timespec &modified = info.st_mtim;
+#endif
+    stamp.size = (int64_t)info.st_size;
+    stamp.modified = (int64_t)modified.tv_sec * 1000000000 + modified.tv_nsec;
+    return stamp;
+}
+
+bool saveFoodDataSnapshot(const string &path, const vector<Food> &foods, const CsvStamp &csv)
+{
+    ScopedTimer timer("saveFoodDataSnapshot");
+    vector<SnapshotRecord> records;
+    string names;
+    records.reserve(foods.size());
+    for (auto i = foods.begin(); i != foods.end(); ++i)
+    {
+        SnapshotRecord record;
+        const string &name = i->getName();
+        record.nameOffset = names.size();
+        record.nameLength = (uint32_t)name.size();
+        record.grams = i->getGrams();
+        record.servings = i->getServings();
+        record.calories = i->getCal();
+        record.protein = i->getProtein();
+        record.carbs = i->getCarb();
+        record.fat = i->getFat();
+        records.push_back(record);
+        names += name;
+    }
+
+    SnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.count = records.size();
+    header.nameBytes = names.size();
+    header.csvSize = csv.size;
+    header.csvModified = csv.modified;
+
+    string tempPath = path + ".tmp";
+    countFileOpen(tempPath);
+    FILE *out = fopen(tempPath.c_str(), "wb");
+    if (out == nullptr)
+        return false;
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1;
+    if (ok && !records.empty())
+        ok = fwrite(records.data(), sizeof(SnapshotRecord), records.size(), out) == records.size();
+    if (ok && !names.empty())
+        ok = fwrite(names.data(), 1, names.size(), out) == names.size();
+    ok = (fclose(out) == 0) && ok;
+    if (!ok || rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        remove(tempPath.c_str());
+        return false;
+    }
+    countBytesWritten(sizeof(header) + records.size() * sizeof(SnapshotRecord) + names.size());
+    return true;
+}
+
+bool isSnapshotCurrent(const string &snapshotPath, const string &csvPath)
+{
+    SnapshotHeader header;
+    FILE *in = fopen(snapshotPath.c_str(), "rb");
+    if (in == nullptr)
+        return false;
+    bool read = fread(&header, sizeof(header), 1, in) == 1;
+    fclose(in);
+    if (!read || memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || header.version != SNAPSHOT_VERSION)
+        return false;
+    CsvStamp csv = csvStampOf(csvPath);
+    if (csv.size < 0)
+        return true; // nothing newer to rebuild from
+    return csv.size == header.csvSize && csv.modified == header.csvModified;
+}
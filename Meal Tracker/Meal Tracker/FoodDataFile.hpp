@@ -0,0 +1,45 @@
+//
+//  FoodDataFile.hpp
+//  Meal Tracker
+//
+//  Loading the food dictionary from disk. The csv is memory mapped and the
+//  fields are parsed straight out of the mapping, only the name gets copied.
+//  FoodData.bin is a binary snapshot of the same foods that loads without
+//  any parsing, it gets rebuilt from the csv whenever the csv changed. The
+//  snapshot header keeps the size and modification time (to the
+//  nanosecond) the csv had, an edit in the same second still shows.
+//
+
+#ifndef FoodDataFile_hpp
+#define FoodDataFile_hpp
+#include "Food.hpp"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdio.h>
+
+using std::string;
+using std::vector;
+
+// Appends every row of a FoodData.csv style file to foods, returns how many were added or -1 if the file can't be opened
+int loadFoodDataCsv(const string &path, vector<Food> &foods);
+
+// Same as loadFoodDataCsv for a snapshot, -1 also covers a snapshot with the wrong version or a cut off file
+int loadFoodDataSnapshot(const string &path, vector<Food> &foods);
+
+// What the csv looked like when the foods were read from it or written to it
+struct CsvStamp
+{
+    int64_t size = -1; // -1 when there was no csv
+    int64_t modified = -1; // nanoseconds since the epoch
+};
+
+CsvStamp csvStampOf(const string &csvPath);
+
+// Writes the snapshot next to the path first and renames it over, so a crash never leaves half a snapshot
+bool saveFoodDataSnapshot(const string &path, const vector<Food> &foods, const CsvStamp &csv);
+
+// True when the snapshot exists and was made from the csv as it is now, or there is no csv
+bool isSnapshotCurrent(const string &snapshotPath, const string &csvPath);
+
+#endif /* FoodDataFile_hpp */
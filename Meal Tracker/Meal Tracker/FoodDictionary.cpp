@@ -0,0 +1,182 @@
+//
+//  FoodDictionary.cpp
+//  Meal Tracker
+//
+
+#include "FoodDictionary.hpp"
+#include "SessionStats.hpp"
+#include <atomic>
+#include <cctype>
+#include <utility>
+
+static string foldName(const string &name)
+{
+    string folded;
+    folded.reserve(name.size());
+    for (char ch : name)
+        folded += std::tolower(static_cast<unsigned char>(ch));
+    return folded;
+}
+
+struct CachedSnapshot
+{
+    uint64_t dictionary = 0; // the mId it came from, 0 before the first read
+    uint64_t version = 0;
+    shared_ptr<const DictionarySnapshot> snapshot;
+};
+
+static std::atomic<uint64_t> gNextDictionaryId(1);
+static thread_local CachedSnapshot tCached;
+
+DictionarySnapshot::DictionarySnapshot()
+{
+    mVersion = 0;
+}
+
+DictionarySnapshot::~DictionarySnapshot()
+{
+
+}
+
+const vector<Food> &DictionarySnapshot::foods() const
+{
+    return mFoods;
+}
+
+const Food &DictionarySnapshot::food(int position) const
+{
+    return mFoods[position];
+}
+
+int DictionarySnapshot::size() const
+{
+    return (int)mFoods.size();
+}
+
+int DictionarySnapshot::find(const string &name) const
+{
+    ScopedTimer timer("DictionarySnapshot::find");
+    auto found = mNameIndex.find(foldName(name));
+    return found == mNameIndex.end() ? -1 : found->second;
+}
+
+vector<int> DictionarySnapshot::suggest(const string &query, int k) const
+{
+    ScopedTimer timer("DictionarySnapshot::suggest");
+    return mSearch.suggest(query, k);
+}
+
+uint64_t DictionarySnapshot::version() const
+{
+    return mVersion;
+}
+
+void DictionarySnapshot::indexAll()
+{
+    mNameIndex.clear();
+    mNameIndex.reserve(mFoods.size());
+    mSearch.clear();
+    for (int i = 0; i < (int)mFoods.size(); i++)
+    {
+        mNameIndex.emplace(foldName(mFoods[i].getName()), i);
+    }
+    mSearch.addNames(mFoods);
+}
+
+FoodDictionary::FoodDictionary()
+{
+    mId = gNextDictionaryId.fetch_add(1);
+    mVersion = 0;
+    mCurrent = std::make_shared<const DictionarySnapshot>();
+}
+
+FoodDictionary::~FoodDictionary()
+{
+
+}
+
+shared_ptr<const DictionarySnapshot> FoodDictionary::snapshot() const
+{
+    return cached();
+}
+
+const DictionarySnapshot &FoodDictionary::current() const
+{
+    return *cached();
+}
+
+// the usual read is one atomic load and a compare, the snapshot is only loaded again after a publish
+const shared_ptr<const DictionarySnapshot> &FoodDictionary::cached() const
+{
+    uint64_t version = mVersion.load(std::memory_order_acquire);
+    if (tCached.dictionary != mId || tCached.version != version)
+    {
+        tCached.snapshot = loadCurrent();
+        tCached.dictionary = mId;
+        tCached.version = tCached.snapshot->version(); // may be newer than version, that's fine
+    }
+    return tCached.snapshot;
+}
+
+shared_ptr<const DictionarySnapshot> FoodDictionary::loadCurrent() const
+{
+#if defined(__cpp_lib_atomic_shared_ptr)
+    return mCurrent.load(std::memory_order_acquire);
+#else
+    return std::atomic_load(&mCurrent);
+#endif
+}
+
+uint64_t FoodDictionary::version() const
+{
+    return mVersion.load(std::memory_order_acquire);
+}
+
+// called with mWriteLock held
+void FoodDictionary::install(shared_ptr<DictionarySnapshot> next)
+{
+    next->mVersion = mVersion.load(std::memory_order_relaxed) + 1;
+    uint64_t version = next->mVersion;
+#if defined(__cpp_lib_atomic_shared_ptr)
+    mCurrent.store(std::move(next), std::memory_order_release);
+#else
+    std::atomic_store(&mCurrent, shared_ptr<const DictionarySnapshot>(std::move(next)));
+#endif
+    mVersion.store(version, std::memory_order_release);
+}
+
+void FoodDictionary::publish(vector<Food> foods)
+{
+    auto next = std::make_shared<DictionarySnapshot>();
+    next->mFoods = std::move(foods);
+    next->indexAll();
+    std::lock_guard<std::mutex> lock(mWriteLock);
+    install(next);
+}
+
+int FoodDictionary::add(const Food &food)
+{
+    std::lock_guard<std::mutex> lock(mWriteLock);
+    auto next = std::make_shared<DictionarySnapshot>(*loadCurrent());
+    int position = (int)next->mFoods.size();
+    next->mFoods.push_back(food);
+    next->mNameIndex.emplace(foldName(food.getName()), position);
+    next->mSearch.addName(food.getName(), position);
+    install(next);
+    return position;
+}
+
+bool FoodDictionary::replace(int position, const Food &food)
+{
+    std::lock_guard<std::mutex> lock(mWriteLock);
+    shared_ptr<const DictionarySnapshot> current = loadCurrent();
+    if (position < 0 || position >= current->size())
+        return false;
+    auto next = std::make_shared<DictionarySnapshot>(*current);
+    bool renamed = next->mFoods[position].getName() != food.getName();
+    next->mFoods[position] = food;
+    if (renamed)
+        next->indexAll(); // keeps repeated names pointing at the first food with that name
+    install(next);
+    return true;
+}
@@ -0,0 +1,93 @@
+//
+//  FoodDictionary.hpp
+//  Meal Tracker
+//
+//  The food dictionary shared by every profile. Readers take a snapshot, an
+//  immutable version of the foods with its name index and autocomplete, and
+//  use it for as long as they like. Writers copy the current version, change
+//  the copy and publish it; whoever still holds the old snapshot keeps seeing
+//  it until they let go, and it is freed then. Writes are rare (adding or
+//  editing a food) so they pay for a copy each.
+//
+//  Each thread keeps the last snapshot it read and only checks an atomic
+//  version number against it, so a read takes no lock unless something was
+//  published since that thread last looked. Then it loads the new snapshot
+//  once, which is std::atomic<shared_ptr> where the library has it and the
+//  older atomic_load functions where it doesn't; both can take a short
+//  internal lock in libstdc++. A thread holds on to its last snapshot until
+//  it reads again.
+//
+
+#ifndef FoodDictionary_hpp
+#define FoodDictionary_hpp
+#include "Food.hpp"
+#include "FoodSearch.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <cstdint>
+#include <stdio.h>
+
+using std::string;
+using std::vector;
+using std::shared_ptr;
+using std::unordered_map;
+
+class DictionarySnapshot
+{
+public:
+    DictionarySnapshot();
+    ~DictionarySnapshot();
+
+    const vector<Food> &foods() const;
+    const Food &food(int position) const;
+    int size() const;
+    int find(const string &name) const; // position of the food, case doesn't matter, -1 if it isn't there
+    vector<int> suggest(const string &query, int k) const; // autocomplete, see FoodSearch
+    uint64_t version() const; // goes up by one with every publish
+
+private:
+    friend class FoodDictionary;
+    void indexAll();
+
+    vector<Food> mFoods;
+    unordered_map<string, int> mNameIndex; // lowercase name -> position, the first food wins when names repeat
+    FoodSearch mSearch;
+    uint64_t mVersion;
+};
+
+class FoodDictionary
+{
+public:
+    FoodDictionary();
+    ~FoodDictionary();
+    FoodDictionary(const FoodDictionary &) = delete;
+    FoodDictionary &operator=(const FoodDictionary &) = delete;
+
+    shared_ptr<const DictionarySnapshot> snapshot() const; // never waits on a writer
+    const DictionarySnapshot &current() const; // like snapshot() without a reference count, good until this thread reads a dictionary again
+
+    void publish(vector<Food> foods); // replaces every food, after loading the dictionary files
+    int add(const Food &food); // returns the new food's position
+    bool replace(int position, const Food &food); // false if there is no food at position
+    uint64_t version() const;
+
+private:
+    const shared_ptr<const DictionarySnapshot> &cached() const; // this thread's copy of the current snapshot
+    shared_ptr<const DictionarySnapshot> loadCurrent() const;
+    void install(shared_ptr<DictionarySnapshot> next);
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<shared_ptr<const DictionarySnapshot>> mCurrent;
+#else
+    shared_ptr<const DictionarySnapshot> mCurrent; // only read and written through std::atomic_load and atomic_store
+#endif
+    std::atomic<uint64_t> mVersion; // mCurrent's version, stored after mCurrent so a reader who sees it finds the snapshot
+    uint64_t mId; // tells the dictionaries apart in the per-thread cache, never reused
+    std::mutex mWriteLock; // one writer at a time, readers never take it
+};
+
+#endif /* FoodDictionary_hpp */
@@ -0,0 +1,217 @@
+//
+//  FoodSearch.cpp
+//  Meal Tracker
+//
+
+#include "FoodSearch.hpp"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <tuple>
+
+static string foldName(const string &input)
+{
+    string result = input;
+    for (char &ch : result)
+    {
+        ch = std::tolower(static_cast<unsigned char>(ch));
+    }
+    return result;
+}
+
+// Pads the name so the first letters get their own trigrams, "egg" -> "  e", " eg", "egg", "gg "
+static vector<uint32_t> trigramsOf(const string &folded)
+{
+    vector<uint32_t> grams;
+    string padded = "  " + folded + " ";
+    for (size_t i = 0; i + 3 <= padded.size(); i++)
+    {
+        uint32_t gram = ((uint32_t)(unsigned char)padded[i] << 16) | ((uint32_t)(unsigned char)padded[i + 1] << 8) | (uint32_t)(unsigned char)padded[i + 2];
+        grams.push_back(gram);
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+// Edit distance between a and b, gives up and returns limit + 1 once it is clear the distance is over limit
+static int editDistance(const string &a, const string &b, int limit)
+{
+    int lengthGap = (int)a.size() - (int)b.size();
+    if (lengthGap > limit || -lengthGap > limit)
+        return limit + 1;
+
+    vector<int> previous(b.size() + 1), current(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); j++)
+        previous[j] = (int)j;
+
+    for (size_t i = 1; i <= a.size(); i++)
+    {
+        current[0] = (int)i;
+        int rowBest = current[0];
+        for (size_t j = 1; j <= b.size(); j++)
+        {
+            int cost = (a[i - 1] == b[j - 1]) ? 0 : 1;
+            current[j] = std::min({previous[j] + 1, current[j - 1] + 1, previous[j - 1] + cost});
+            rowBest = std::min(rowBest, current[j]);
+        }
+        if (rowBest > limit)
+            return limit + 1;
+        previous.swap(current);
+    }
+    return previous[b.size()];
+}
+
+FoodSearch::FoodSearch()
+{
+
+}
+
+FoodSearch::~FoodSearch()
+{
+
+}
+
+void FoodSearch::clear()
+{
+    mNames.clear();
+    mPositions.clear();
+    mSorted.clear();
+    mTrigrams.clear();
+}
+
+int FoodSearch::size() const
+{
+    return (int)mNames.size();
+}
+
+void FoodSearch::addName(const string &name, int position)
+{
+    int entry = (int)mNames.size();
+    string folded = foldName(name);
+    mNames.push_back(folded);
+    mPositions.push_back(position);
+
+    pair<string, int> key(folded, entry);
+    mSorted.insert(std::lower_bound(mSorted.begin(), mSorted.end(), key), key);
+    addTrigrams(folded, entry);
+}
+
+void FoodSearch::addNames(const vector<Food> &foods)
+{
+    mNames.reserve(mNames.size() + foods.size());
+    mPositions.reserve(mPositions.size() + foods.size());
+    mSorted.reserve(mSorted.size() + foods.size());
+    for (int position = 0; position < (int)foods.size(); position++)
+    {
+        int entry = (int)mNames.size();
+        string folded = foldName(foods[position].getName());
+        mSorted.emplace_back(folded, entry);
+        addTrigrams(folded, entry);
+        mNames.push_back(std::move(folded));
+        mPositions.push_back(position);
+    }
+    std::sort(mSorted.begin(), mSorted.end());
+}
+
+void FoodSearch::addTrigrams(const string &folded, int entry)
+{
+    for (uint32_t gram : trigramsOf(folded))
+    {
+        mTrigrams[gram].push_back(entry);
+    }
+}
+
+vector<int> FoodSearch::suggest(const string &query, int k) const
+{
+    vector<int> entries;
+    string folded = foldName(query);
+    if (folded.empty() || k <= 0)
+        return entries;
+
+    // prefix matches are contiguous in the sorted list
+    auto it = std::lower_bound(mSorted.begin(), mSorted.end(), pair<string, int>(folded, INT_MIN));
+    for (; it != mSorted.end() && (int)entries.size() < k; ++it)
+    {
+        if (it->first.compare(0, folded.size(), folded) != 0)
+            break;
+        entries.push_back(it->second);
+    }
+
+    if ((int)entries.size() < k)
+    {
+        // count the trigrams each name shares with the query, only names that share some get an edit distance check.
+        // The counts live in a buffer the thread keeps between calls, only the slots that were hit get zeroed again
+        thread_local vector<uint16_t> shared;
+        if (shared.size() < mNames.size())
+            shared.resize(mNames.size(), 0);
+        vector<uint32_t> grams = trigramsOf(folded);
+        vector<int> touched;
+        for (uint32_t gram : grams)
+        {
+            auto found = mTrigrams.find(gram);
+            if (found == mTrigrams.end())
+                continue;
+            for (int entry : found->second)
+            {
+                if (shared[entry] == 0)
+                    touched.push_back(entry);
+                shared[entry]++;
+            }
+        }
+
+        int minShared = std::max(1, (int)grams.size() / 3);
+        vector<pair<int, int> > candidates; // shared trigrams, entry
+        for (int entry : touched)
+        {
+            if (shared[entry] >= minShared)
+                candidates.emplace_back(shared[entry], entry);
+            shared[entry] = 0;
+        }
+
+        const size_t maxCandidates = 64;
+        if (candidates.size() > maxCandidates)
+        {
+            std::partial_sort(candidates.begin(), candidates.begin() + maxCandidates, candidates.end(), [](const pair<int, int> &a, const pair<int, int> &b) { return a.first > b.first; });
+            candidates.resize(maxCandidates);
+        }
+
+        int limit = std::max(1, (int)folded.size() / 3);
+        vector<std::tuple<int, int, int> > scored; // distance, shared trigrams, entry
+        for (const auto &candidate : candidates)
+        {
+            const string &name = mNames[candidate.second];
+            int distance = editDistance(folded, name, limit);
+            if (name.size() > folded.size())
+            {
+                // the user may have only typed the start of the name
+                distance = std::min(distance, editDistance(folded, name.substr(0, folded.size()), limit));
+            }
+            if (distance <= limit)
+                scored.emplace_back(distance, candidate.first, candidate.second);
+        }
+        std::sort(scored.begin(), scored.end(), [&](const std::tuple<int, int, int> &a, const std::tuple<int, int, int> &b) {
+            if (std::get<0>(a) != std::get<0>(b))
+                return std::get<0>(a) < std::get<0>(b);
+            if (std::get<1>(a) != std::get<1>(b))
+                return std::get<1>(a) > std::get<1>(b);
+            return mNames[std::get<2>(a)] < mNames[std::get<2>(b)];
+        });
+
+        for (const auto &score : scored)
+        {
+            if ((int)entries.size() >= k)
+                break;
+            if (std::find(entries.begin(), entries.end(), std::get<2>(score)) == entries.end())
+                entries.push_back(std::get<2>(score));
+        }
+    }
+
+    vector<int> positions;
+    positions.reserve(entries.size());
+    for (int entry : entries)
+    {
+        positions.push_back(mPositions[entry]);
+    }
+    return positions;
+}
@@ -0,0 +1,45 @@
+//
+//  FoodSearch.hpp
+//  Meal Tracker
+//
+//  Autocomplete for food names: prefix matches from a sorted name list and
+//  typo matches from a trigram index checked with edit distance.
+//
+
+#ifndef FoodSearch_hpp
+#define FoodSearch_hpp
+#include "Food.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <stdio.h>
+
+using std::string;
+using std::vector;
+using std::pair;
+using std::unordered_map;
+
+
+class FoodSearch
+{
+public:
+    FoodSearch();
+    ~FoodSearch();
+
+    void clear();
+    void addName(const string &name, int position); // position is where the food sits in the dictionary
+    void addNames(const vector<Food> &foods); // every food in the dictionary, the name list is sorted once at the end
+    vector<int> suggest(const string &query, int k) const; // best k positions, prefix matches first
+    int size() const;
+
+private:
+    void addTrigrams(const string &folded, int entry);
+
+    vector<string> mNames; // lowercase names, one per entry
+    vector<int> mPositions; // dictionary position of each entry
+    vector<pair<string, int> > mSorted; // lowercase name -> entry, sorted for prefix lookups
+    unordered_map<uint32_t, vector<int> > mTrigrams; // trigram -> entries containing it
+};
+
+#endif /* FoodSearch_hpp */
@@ -0,0 +1,405 @@
+//
+//  HttpServer.cpp
+//  Meal Tracker
+//
+
+#include "HttpServer.hpp"
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <fcntl.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // macOS has no send flag for it, SO_NOSIGPIPE is set on the socket instead
+#endif
+
+static const size_t MAX_HEADER_BYTES = 16 * 1024;
+static const size_t MAX_BODY_BYTES = 1024 * 1024;
+static const int IDLE_SECONDS = 5; // a kept alive connection that says nothing for this long is closed, and a send stuck this long gives up
+
+HttpResponse::HttpResponse(int status, const string &body, const string &contentType)
+    : status(status), body(body), contentType(contentType)
+{
+
+}
+
+static const char *reasonFor(int status)
+{
+    switch (status)
+    {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        case 500: return "Internal Server Error";
+        default: return "Unknown";
+    }
+}
+
+static string urlDecode(const string &text)
+{
+    string out;
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        if (text[i] == '+')
+            out += ' ';
+        else if (text[i] == '%' && i + 2 < text.size() && std::isxdigit(static_cast<unsigned char>(text[i + 1])) && std::isxdigit(static_cast<unsigned char>(text[i + 2])))
+        {
+            out += (char)strtol(text.substr(i + 1, 2).c_str(), nullptr, 16);
+            i += 2;
+        }
+        else
+            out += text[i];
+    }
+    return out;
+}
+
+static void parseQuery(const string &text, unordered_map<string, string> &query)
+{
+    size_t start = 0;
+    while (start < text.size())
+    {
+        size_t end = text.find('&', start);
+        if (end == string::npos)
+            end = text.size();
+        string pair = text.substr(start, end - start);
+        size_t equals = pair.find('=');
+        if (!pair.empty())
+        {
+            if (equals == string::npos)
+                query[urlDecode(pair)] = "";
+            else
+                query[urlDecode(pair.substr(0, equals))] = urlDecode(pair.substr(equals + 1));
+        }
+        start = end + 1;
+    }
+}
+
+static bool sendAll(int fd, const string &data)
+{
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        ssize_t result = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (result <= 0)
+            return false;
+        sent += (size_t)result;
+    }
+    return true;
+}
+
+// the first request in the buffer: 0 when it hasn't all come in yet, 200 with the request
+// and how many bytes it took, or the status to close the connection with
+static int parseRequest(const string &buffer, HttpRequest &request, bool &keepAlive, size_t &used)
+{
+    size_t headerEnd = buffer.find("\r\n\r\n");
+    if (headerEnd == string::npos)
+        return buffer.size() > MAX_HEADER_BYTES ? 400 : 0;
+
+    size_t lineEnd = buffer.find("\r\n");
+    string requestLine = buffer.substr(0, lineEnd);
+    size_t firstSpace = requestLine.find(' ');
+    size_t secondSpace = requestLine.find(' ', firstSpace + 1);
+    if (firstSpace == string::npos || secondSpace == string::npos)
+        return 400;
+    request.method = requestLine.substr(0, firstSpace);
+    string target = requestLine.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+    keepAlive = requestLine.compare(secondSpace + 1, string::npos, "HTTP/1.1") == 0;
+    size_t question = target.find('?');
+    request.path = urlDecode(target.substr(0, question));
+    request.query.clear();
+    if (question != string::npos)
+        parseQuery(target.substr(question + 1), request.query);
+
+    size_t contentLength = 0;
+    size_t at = lineEnd + 2;
+    while (at < headerEnd)
+    {
+        size_t end = buffer.find("\r\n", at);
+        string line = buffer.substr(at, end - at);
+        at = end + 2;
+        size_t colon = line.find(':');
+        if (colon == string::npos)
+            continue;
+        string name = line.substr(0, colon);
+        for (auto &ch : name)
+            ch = (char)std::tolower(static_cast<unsigned char>(ch));
+        size_t valueStart = line.find_first_not_of(' ', colon + 1);
+        string value = valueStart == string::npos ? "" : line.substr(valueStart);
+        if (name == "content-length")
+            contentLength = strtoul(value.c_str(), nullptr, 10);
+        else if (name == "connection")
+        {
+            for (auto &ch : value)
+                ch = (char)std::tolower(static_cast<unsigned char>(ch));
+            if (value == "close")
+                keepAlive = false;
+            else if (value == "keep-alive")
+                keepAlive = true;
+        }
+    }
+    if (contentLength > MAX_BODY_BYTES)
+        return 413;
+    size_t bodyStart = headerEnd + 4;
+    if (buffer.size() < bodyStart + contentLength)
+        return 0;
+    request.body = buffer.substr(bodyStart, contentLength);
+    used = bodyStart + contentLength;
+    return 200;
+}
+
+HttpServer::HttpServer()
+{
+    mListenFd = -1;
+    mPort = 0;
+    mStopping = false;
+    mWake[0] = mWake[1] = -1;
+}
+
+HttpServer::~HttpServer()
+{
+    stop();
+    mReady.notify_all();
+    for (auto &worker : mWorkers)
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+    closeAll(mWaiting);
+    closeAll(mReturned);
+    if (mListenFd >= 0)
+        close(mListenFd);
+    if (mWake[0] >= 0)
+    {
+        close(mWake[0]);
+        close(mWake[1]);
+    }
+}
+
+void HttpServer::closeAll(deque<HttpConnection> &connections)
+{
+    for (auto &connection : connections)
+        close(connection.fd);
+    connections.clear();
+}
+
+bool HttpServer::start(int port, int threads, HttpHandler handler)
+{
+    mHandler = handler;
+    if (pipe(mWake) != 0)
+    {
+        mWake[0] = mWake[1] = -1;
+        return false;
+    }
+    fcntl(mWake[0], F_SETFL, O_NONBLOCK);
+    fcntl(mWake[1], F_SETFL, O_NONBLOCK);
+    mListenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (mListenFd < 0)
+        return false;
+    int yes = 1;
+    setsockopt(mListenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((uint16_t)port);
+    if (bind(mListenFd, (sockaddr *)&address, sizeof(address)) != 0 || listen(mListenFd, 128) != 0)
+    {
+        close(mListenFd);
+        mListenFd = -1;
+        return false;
+    }
+    socklen_t length = sizeof(address);
+    getsockname(mListenFd, (sockaddr *)&address, &length);
+    mPort = ntohs(address.sin_port);
+
+    if (threads < 1)
+        threads = 1;
+    for (int t = 0; t < threads; t++)
+        mWorkers.emplace_back(&HttpServer::work, this);
+    return true;
+}
+
+void HttpServer::run()
+{
+    deque<HttpConnection> idle; // kept alive with nothing to read, or half a request
+    vector<pollfd> polled;
+    while (!mStopping)
+    {
+        auto now = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            for (auto &connection : mReturned)
+            {
+                connection.idleSince = now;
+                idle.push_back(std::move(connection));
+            }
+            mReturned.clear();
+        }
+        polled.clear();
+        polled.push_back({mListenFd, POLLIN, 0});
+        polled.push_back({mWake[0], POLLIN, 0});
+        for (auto &connection : idle)
+            polled.push_back({connection.fd, POLLIN, 0});
+
+        // wake up now and then to notice stop() and connections that have gone quiet
+        int ready = poll(polled.data(), (nfds_t)polled.size(), 200);
+        now = std::chrono::steady_clock::now();
+        if (ready > 0 && (polled[1].revents & POLLIN))
+        {
+            char drained[64];
+            while (read(mWake[0], drained, sizeof(drained)) > 0)
+            {
+            }
+        }
+
+        deque<HttpConnection> stillIdle, readable;
+        for (size_t i = 0; i < idle.size(); i++)
+        {
+            if (ready > 0 && polled[i + 2].revents != 0)
+                readable.push_back(std::move(idle[i]));
+            else if (now - idle[i].idleSince >= std::chrono::seconds(IDLE_SECONDS))
+                close(idle[i].fd);
+            else
+                stillIdle.push_back(std::move(idle[i]));
+        }
+        idle.swap(stillIdle);
+
+        if (ready > 0 && (polled[0].revents & POLLIN))
+        {
+            int fd = accept(mListenFd, nullptr, nullptr);
+            if (fd >= 0)
+            {
+                int yes = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+#ifdef SO_NOSIGPIPE
+                setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(yes));
+#endif
+                timeval stuck = {IDLE_SECONDS, 0};
+                setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &stuck, sizeof(stuck));
+                idle.push_back({fd, string(), now}); // polled until the request comes in
+            }
+        }
+
+        if (!readable.empty())
+        {
+            {
+                std::lock_guard<std::mutex> lock(mLock);
+                for (auto &connection : readable)
+                    mWaiting.push_back(std::move(connection));
+            }
+            if (readable.size() == 1)
+                mReady.notify_one();
+            else
+                mReady.notify_all();
+        }
+    }
+    closeAll(idle);
+    mReady.notify_all();
+}
+
+void HttpServer::stop()
+{
+    mStopping = true;
+}
+
+int HttpServer::port() const
+{
+    return mPort;
+}
+
+void HttpServer::work()
+{
+    while (true)
+    {
+        HttpConnection connection;
+        {
+            std::unique_lock<std::mutex> lock(mLock);
+            mReady.wait_for(lock, std::chrono::milliseconds(200), [this] { return mStopping || !mWaiting.empty(); });
+            if (mWaiting.empty())
+            {
+                if (mStopping)
+                    return;
+                continue;
+            }
+            connection = std::move(mWaiting.front());
+            mWaiting.pop_front();
+        }
+        if (!serve(connection) || mStopping)
+        {
+            close(connection.fd);
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            mReturned.push_back(std::move(connection));
+        }
+        char wake = 0;
+        if (write(mWake[1], &wake, 1) < 0)
+        {
+            // the pipe is full, run() is going to look at mReturned anyway
+        }
+    }
+}
+
+// reads what the client has sent without waiting for more and answers every whole request in it
+bool HttpServer::serve(HttpConnection &connection)
+{
+    char chunk[8192];
+    bool closed = false;
+    while (connection.buffer.size() <= MAX_HEADER_BYTES + MAX_BODY_BYTES)
+    {
+        ssize_t received = recv(connection.fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+        if (received > 0)
+            connection.buffer.append(chunk, (size_t)received);
+        else if (received == 0)
+        {
+            closed = true;
+            break;
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            break;
+        else if (errno != EINTR)
+            return false;
+    }
+
+    HttpRequest request;
+    bool keepAlive = true;
+    size_t used = 0;
+    int status;
+    while (keepAlive && !mStopping && (status = parseRequest(connection.buffer, request, keepAlive, used)) != 0)
+    {
+        if (status == 400)
+        {
+            sendAll(connection.fd, "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+            return false;
+        }
+        if (status == 413)
+        {
+            sendAll(connection.fd, "HTTP/1.1 413 Payload Too Large\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+            return false;
+        }
+        connection.buffer.erase(0, used); // a pipelined request may already be waiting behind this one
+
+        HttpResponse response = mHandler(request);
+        string out = "HTTP/1.1 " + std::to_string(response.status) + " " + reasonFor(response.status) + "\r\n";
+        out += "Content-Type: " + response.contentType + "\r\n";
+        out += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+        out += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+        out += response.body;
+        if (!sendAll(connection.fd, out))
+            return false;
+    }
+    return keepAlive && !closed;
+}
@@ -0,0 +1,87 @@
+//
+//  HttpServer.hpp
+//  Meal Tracker
+//
+//  A small HTTP/1.1 server for the tracker's JSON endpoints. It only listens
+//  on 127.0.0.1. One thread accepts connections and polls the ones kept
+//  alive; a connection with something to read goes to a fixed pool of
+//  workers, which answer what has come in and hand it back, so an idle
+//  client never holds on to a worker.
+//
+
+#ifndef HttpServer_hpp
+#define HttpServer_hpp
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+#include <stdio.h>
+
+using std::string;
+using std::vector;
+using std::deque;
+using std::unordered_map;
+
+struct HttpRequest
+{
+    string method;
+    string path; // without the query string
+    unordered_map<string, string> query; // decoded ?name=value pairs
+    string body;
+};
+
+struct HttpResponse
+{
+    int status;
+    string body;
+    string contentType;
+
+    HttpResponse(int status = 200, const string &body = "", const string &contentType = "application/json");
+};
+
+typedef std::function<HttpResponse(const HttpRequest &)> HttpHandler;
+
+struct HttpConnection
+{
+    int fd;
+    string buffer; // read but not answered yet, the start of the next request
+    std::chrono::steady_clock::time_point idleSince;
+};
+
+class HttpServer
+{
+public:
+    HttpServer();
+    ~HttpServer();
+    HttpServer(const HttpServer &) = delete;
+    HttpServer &operator=(const HttpServer &) = delete;
+
+    bool start(int port, int threads, HttpHandler handler); // port 0 picks a free one
+    void run(); // serves until stop() is called
+    void stop(); // safe to call from a signal handler or another thread
+    int port() const;
+
+private:
+    void work();
+    bool serve(HttpConnection &connection); // false when the connection is done with
+    void closeAll(deque<HttpConnection> &connections);
+
+    HttpHandler mHandler;
+    int mListenFd;
+    int mPort;
+    std::atomic<bool> mStopping;
+    vector<std::thread> mWorkers;
+    int mWake[2]; // a worker writes to it when it hands a connection back
+    deque<HttpConnection> mWaiting; // connections with something to read no worker has picked up yet
+    deque<HttpConnection> mReturned; // handed back by the workers, not polled again yet
+    std::mutex mLock;
+    std::condition_variable mReady;
+};
+
+#endif /* HttpServer_hpp */
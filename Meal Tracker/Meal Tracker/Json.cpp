@@ -0,0 +1,276 @@
+//
+//  Json.cpp
+//  Meal Tracker
+//
+
+#include "Json.hpp"
+#include <cctype>
+#include <cmath>
+
+JsonWriter::JsonWriter()
+{
+    mAfterKey = false;
+}
+
+JsonWriter::~JsonWriter()
+{
+
+}
+
+void JsonWriter::separate()
+{
+    if (mAfterKey)
+    {
+        mAfterKey = false;
+        return;
+    }
+    if (!mFirst.empty())
+    {
+        if (!mFirst.back())
+            mOut += ',';
+        mFirst.back() = false;
+    }
+}
+
+JsonWriter &JsonWriter::beginObject()
+{
+    separate();
+    mOut += '{';
+    mFirst.push_back(true);
+    return *this;
+}
+
+JsonWriter &JsonWriter::endObject()
+{
+    mOut += '}';
+    mFirst.pop_back();
+    return *this;
+}
+
+JsonWriter &JsonWriter::beginArray()
+{
+    separate();
+    mOut += '[';
+    mFirst.push_back(true);
+    return *this;
+}
+
+JsonWriter &JsonWriter::endArray()
+{
+    mOut += ']';
+    mFirst.pop_back();
+    return *this;
+}
+
+JsonWriter &JsonWriter::key(const string &name)
+{
+    separate();
+    mOut += jsonQuote(name);
+    mOut += ':';
+    mAfterKey = true;
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const string &text)
+{
+    separate();
+    mOut += jsonQuote(text);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const char *text)
+{
+    return value(string(text));
+}
+
+JsonWriter &JsonWriter::value(double number)
+{
+    separate();
+    if (!std::isfinite(number))
+    {
+        mOut += "null";
+        return *this;
+    }
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.10g", number);
+    mOut += buffer;
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(int number)
+{
+    separate();
+    mOut += std::to_string(number);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(bool flag)
+{
+    separate();
+    mOut += flag ? "true" : "false";
+    return *this;
+}
+
+const string &JsonWriter::str() const
+{
+    return mOut;
+}
+
+string jsonQuote(const string &text)
+{
+    string out = "\"";
+    for (char ch : text)
+    {
+        switch (ch)
+        {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if ((unsigned char)ch < 0x20)
+                {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\u%04x", (unsigned char)ch);
+                    out += buffer;
+                }
+                else
+                    out += ch;
+        }
+    }
+    out += '"';
+    return out;
+}
+
+static void skipSpace(const string &text, size_t &at)
+{
+    while (at < text.size() && std::isspace(static_cast<unsigned char>(text[at])))
+        at++;
+}
+
+static void appendUtf8(string &out, unsigned code)
+{
+    if (code < 0x80)
+        out += (char)code;
+    else if (code < 0x800)
+    {
+        out += (char)(0xC0 | (code >> 6));
+        out += (char)(0x80 | (code & 0x3F));
+    }
+    else
+    {
+        out += (char)(0xE0 | (code >> 12));
+        out += (char)(0x80 | ((code >> 6) & 0x3F));
+        out += (char)(0x80 | (code & 0x3F));
+    }
+}
+
+static bool readString(const string &text, size_t &at, string &out)
+{
+    if (at >= text.size() || text[at] != '"')
+        return false;
+    at++;
+    out.clear();
+    while (at < text.size())
+    {
+        char ch = text[at++];
+        if (ch == '"')
+            return true;
+        if (ch != '\\')
+        {
+            out += ch;
+            continue;
+        }
+        if (at >= text.size())
+            return false;
+        char escaped = text[at++];
+        switch (escaped)
+        {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u':
+            {
+                if (at + 4 > text.size())
+                    return false;
+                unsigned code = 0;
+                for (int i = 0; i < 4; i++)
+                {
+                    char hex = text[at++];
+                    if (!std::isxdigit(static_cast<unsigned char>(hex)))
+                        return false;
+                    code = code * 16 + (std::isdigit(static_cast<unsigned char>(hex)) ? hex - '0' : (std::tolower(static_cast<unsigned char>(hex)) - 'a' + 10));
+                }
+                appendUtf8(out, code);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+bool parseJsonObject(const string &text, unordered_map<string, string> &fields)
+{
+    size_t at = 0;
+    skipSpace(text, at);
+    if (at >= text.size() || text[at] != '{')
+        return false;
+    at++;
+    skipSpace(text, at);
+    if (at < text.size() && text[at] == '}')
+    {
+        at++;
+        skipSpace(text, at);
+        return at == text.size();
+    }
+    while (at < text.size())
+    {
+        string name, value;
+        skipSpace(text, at);
+        if (!readString(text, at, name))
+            return false;
+        skipSpace(text, at);
+        if (at >= text.size() || text[at] != ':')
+            return false;
+        at++;
+        skipSpace(text, at);
+        if (at < text.size() && text[at] == '"')
+        {
+            if (!readString(text, at, value))
+                return false;
+        }
+        else
+        {
+            // a number, true, false or null, kept as written
+            size_t start = at;
+            while (at < text.size() && (std::isalnum(static_cast<unsigned char>(text[at])) || text[at] == '-' || text[at] == '+' || text[at] == '.'))
+                at++;
+            if (at == start)
+                return false;
+            value = text.substr(start, at - start);
+        }
+        fields[name] = value;
+        skipSpace(text, at);
+        if (at < text.size() && text[at] == ',')
+        {
+            at++;
+            continue;
+        }
+        if (at < text.size() && text[at] == '}')
+        {
+            at++;
+            skipSpace(text, at);
+            return at == text.size();
+        }
+        return false;
+    }
+    return false;
+}
@@ -0,0 +1,53 @@
+//
+//  Json.hpp
+//  Meal Tracker
+//
+//  Just enough JSON for the server: a writer that builds the response text
+//  as it goes, and a reader for flat request objects whose values are
+//  strings, numbers, true/false or null.
+//
+
+#ifndef Json_hpp
+#define Json_hpp
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <stdio.h>
+
+using std::string;
+using std::vector;
+using std::unordered_map;
+
+class JsonWriter
+{
+public:
+    JsonWriter();
+    ~JsonWriter();
+
+    JsonWriter &beginObject();
+    JsonWriter &endObject();
+    JsonWriter &beginArray();
+    JsonWriter &endArray();
+    JsonWriter &key(const string &name); // inside an object, the value goes next
+    JsonWriter &value(const string &text);
+    JsonWriter &value(const char *text);
+    JsonWriter &value(double number);
+    JsonWriter &value(int number);
+    JsonWriter &value(bool flag);
+
+    const string &str() const;
+
+private:
+    void separate();
+
+    string mOut;
+    vector<bool> mFirst; // one per open object or array, true until something is written in it
+    bool mAfterKey;
+};
+
+string jsonQuote(const string &text); // text as a JSON string literal, quotes included
+
+// Reads {"name": value, ...} into fields, strings unescaped and everything else as written, false on anything else
+bool parseJsonObject(const string &text, unordered_map<string, string> &fields);
+
+#endif /* Json_hpp */
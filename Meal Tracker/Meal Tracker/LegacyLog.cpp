@@ -0,0 +1,245 @@
+//
+//  LegacyLog.cpp
+//  Meal Tracker
+//
+
+#include "LegacyLog.hpp"
+#include "FileScan.hpp"
+#include "Dates.hpp"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <unordered_map>
+
+using std::unordered_map;
+
+static const size_t MIN_PIECE = 1 << 20; // smaller pieces aren't worth a thread
+
+struct Piece
+{
+    const char *first;
+    const char *last;
+    vector<JournalEntry> entries;
+    unordered_map<int, time_t> midnights; // yyyymmdd -> local midnight
+    unordered_map<string_view, uint32_t> names; // name in the file -> id, so the shared pool is only asked once per name
+    int blocks = 0;
+    int skipped = 0;
+};
+
+static bool startsWith(const char *first, const char *last, const char *prefix)
+{
+    size_t length = strlen(prefix);
+    return (size_t)(last - first) >= length && memcmp(first, prefix, length) == 0;
+}
+
+// "Mon Feb 12 09:19:18 2024", the way ctime() wrote it
+static bool parseDate(const char *first, const char *last, Piece &piece, int64_t &timestamp)
+{
+    static const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    while (first < last && *first == ' ')
+        first++;
+    if (last - first < 24 || first[3] != ' ' || first[7] != ' ' || first[10] != ' ' || first[13] != ':' || first[16] != ':' || first[19] != ' ')
+        return false;
+    int month = 0;
+    while (month < 12 && memcmp(first + 4, months[month], 3) != 0)
+        month++;
+    int day = 0, hour = 0, minute = 0, second = 0, year = 0;
+    const char *dayStart = first[8] == ' ' ? first + 9 : first + 8;
+    if (month == 12 || !parseInt(dayStart, first + 10, day) || !parseInt(first + 11, first + 13, hour)
+        || !parseInt(first + 14, first + 16, minute) || !parseInt(first + 17, first + 19, second) || !parseInt(first + 20, first + 24, year))
+        return false;
+
+    int key = year * 10000 + (month + 1) * 100 + day;
+    auto cached = piece.midnights.find(key);
+    if (cached == piece.midnights.end())
+    {
+        time_t midnight = startOfDay(year, month + 1, day);
+        if (midnight == (time_t)-1)
+            return false;
+        cached = piece.midnights.emplace(key, midnight).first;
+    }
+    timestamp = (int64_t)cached->second + hour * 3600 + minute * 60 + second;
+    return true;
+}
+
+// Finds label in [first, last) and reads the number right after it, first moves past the number
+static bool readField(const char *&first, const char *last, const char *label, double &value)
+{
+    size_t length = strlen(label);
+    while (last - first >= (ptrdiff_t)length && memcmp(first, label, length) != 0)
+        first++;
+    if (last - first < (ptrdiff_t)length)
+        return false;
+    first += length;
+    const char *end = first;
+    while (end < last && *end != ' ')
+        end++;
+    bool ok = parseDouble(first, end, value);
+    first = end;
+    return ok;
+}
+
+// "Grams:76  Servings:0  Calories:41  Protein:8.26087  Carbs:0  Fat:0"
+static bool parseAmounts(const char *first, const char *last, JournalEntry &entry)
+{
+    double grams = 0.0, servings = 0.0, calories = 0.0;
+    if (!readField(first, last, "Grams:", grams) || !readField(first, last, "Servings:", servings) || !readField(first, last, "Calories:", calories)
+        || !readField(first, last, "Protein:", entry.protein) || !readField(first, last, "Carbs:", entry.carbs) || !readField(first, last, "Fat:", entry.fat))
+        return false;
+    entry.grams = (int)grams;
+    entry.servings = (int)servings;
+    entry.calories = (int)calories;
+    return true;
+}
+
+static void parsePiece(Piece &piece)
+{
+    int64_t timestamp = 0;
+    bool dated = false, totals = false;
+    const char *name = nullptr, *nameEnd = nullptr;
+    const char *at = piece.first;
+    while (at < piece.last)
+    {
+        const char *end = static_cast<const char *>(memchr(at, '\n', piece.last - at));
+        if (end == nullptr)
+            end = piece.last;
+        const char *line = at, *lineEnd = end;
+        at = end + 1;
+        if (lineEnd > line && lineEnd[-1] == '\r')
+            lineEnd--;
+        if (lineEnd == line)
+            continue;
+
+        if (startsWith(line, lineEnd, "Date:"))
+        {
+            piece.blocks++;
+            dated = parseDate(line + 5, lineEnd, piece, timestamp);
+            if (!dated)
+                piece.skipped++;
+            totals = false;
+            name = nullptr;
+        }
+        else if (startsWith(line, lineEnd, "----"))
+        {
+            dated = false;
+            name = nullptr;
+        }
+        else if (startsWith(line, lineEnd, "Todays Totals:"))
+            totals = true; // the running total on the next line is worked out again from the foods
+        else if (totals)
+            totals = false;
+        else if (startsWith(line, lineEnd, "Grams:"))
+        {
+            JournalEntry entry;
+            if (dated && name != nullptr && parseAmounts(line, lineEnd, entry))
+            {
+                entry.timestamp = timestamp;
+                string_view written(name, nameEnd - name);
+                auto known = piece.names.find(written);
+                if (known == piece.names.end())
+                    known = piece.names.emplace(written, foodNames().intern(written)).first;
+                entry.nameId = known->second;
+                piece.entries.push_back(std::move(entry));
+            }
+            name = nullptr;
+        }
+        else
+        {
+            name = line;
+            nameEnd = lineEnd;
+        }
+    }
+}
+
+LegacyLog::LegacyLog()
+{
+    mBlocks = 0;
+    mSkipped = 0;
+}
+
+LegacyLog::~LegacyLog()
+{
+
+}
+
+bool LegacyLog::read(const string &path, int threads)
+{
+    MappedFile file(path);
+    if (!file.isOpen())
+        return false;
+    parse(file.data(), file.data() + file.size(), threads);
+    return true;
+}
+
+void LegacyLog::parse(const char *first, const char *last, int threads)
+{
+    size_t size = (size_t)(last - first);
+    size_t count = std::max<size_t>(1, std::min<size_t>((size_t)std::max(threads, 1), size / MIN_PIECE));
+
+    // every piece but the first starts on the line after a row of dashes
+    vector<Piece> pieces(count);
+    const char *start = first;
+    for (size_t n = 0; n < count; n++)
+    {
+        pieces[n].first = start;
+        const char *cut = n + 1 == count ? last : first + size / count * (n + 1);
+        if (cut < start)
+            cut = start;
+        while (cut < last)
+        {
+            const char *line = static_cast<const char *>(memchr(cut, '\n', last - cut));
+            if (line == nullptr)
+            {
+                cut = last;
+                break;
+            }
+            cut = line + 1;
+            if (startsWith(cut, last, "----"))
+            {
+                const char *end = static_cast<const char *>(memchr(cut, '\n', last - cut));
+                cut = end == nullptr ? last : end + 1;
+                break;
+            }
+        }
+        pieces[n].last = cut;
+        start = cut;
+    }
+
+    vector<std::thread> workers;
+    for (size_t n = 1; n < count; n++)
+        workers.emplace_back(parsePiece, std::ref(pieces[n]));
+    parsePiece(pieces[0]);
+    for (std::thread &worker : workers)
+        worker.join();
+
+    size_t total = 0;
+    for (const Piece &piece : pieces)
+        total += piece.entries.size();
+    mEntries.clear();
+    mEntries.reserve(total);
+    mBlocks = 0;
+    mSkipped = 0;
+    for (Piece &piece : pieces)
+    {
+        std::move(piece.entries.begin(), piece.entries.end(), std::back_inserter(mEntries));
+        mBlocks += piece.blocks;
+        mSkipped += piece.skipped;
+    }
+}
+
+const vector<JournalEntry> &LegacyLog::entries() const
+{
+    return mEntries;
+}
+
+int LegacyLog::blocks() const
+{
+    return mBlocks;
+}
+
+int LegacyLog::skipped() const
+{
+    return mSkipped;
+}
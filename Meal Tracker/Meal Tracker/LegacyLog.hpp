@@ -0,0 +1,41 @@
+//
+//  LegacyLog.hpp
+//  Meal Tracker
+//
+//  Reads the food log the app wrote before the journal: blocks of a
+//  "Date:" line, each food's name and its "Grams: ... Fat:" line, the
+//  running "Todays Totals:" and a line of dashes. Blocks don't depend on
+//  each other, so the file is cut into pieces at the dashes and every
+//  piece is parsed on its own thread.
+//
+
+#ifndef LegacyLog_hpp
+#define LegacyLog_hpp
+#include "MealJournal.hpp"
+#include <string>
+#include <vector>
+#include <stdio.h>
+
+using std::string;
+using std::vector;
+
+class LegacyLog
+{
+public:
+    LegacyLog();
+    ~LegacyLog();
+
+    bool read(const string &path, int threads); // false if the file can't be opened
+    void parse(const char *first, const char *last, int threads);
+
+    const vector<JournalEntry> &entries() const; // in file order, each food stamped with its block's date
+    int blocks() const;
+    int skipped() const; // blocks whose date couldn't be read, their foods are left out
+
+private:
+    vector<JournalEntry> mEntries;
+    int mBlocks;
+    int mSkipped;
+};
+
+#endif /* LegacyLog_hpp */
@@ -0,0 +1,323 @@
+//
+//  MacroHistory.cpp
+//  Meal Tracker
+//
+
+#include "MacroHistory.hpp"
+#include "Dates.hpp"
+#include "SessionStats.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char HISTORY_MAGIC[4] = {'M', 'T', 'H', 'D'};
+static const uint32_t HISTORY_VERSION = 1;
+static const int HEADER_BYTES = 16;
+static const int INDEX_STRIDE = 64; // one index entry per this many records
+
+static_assert(sizeof(DayMacros) == 32, "history records are written to disk as is");
+
+static off_t recordOffset(int position)
+{
+    return HEADER_BYTES + (off_t)position * (off_t)sizeof(DayMacros);
+}
+
+MacroHistory::MacroHistory(const string &dataPath, const string &indexPath)
+{
+    mDataPath = dataPath;
+    mIndexPath = indexPath;
+    mFd = -1;
+    mCount = 0;
+    mLastDay = -1;
+}
+
+MacroHistory::~MacroHistory()
+{
+    if (mFd >= 0)
+        close(mFd);
+}
+
+bool MacroHistory::open(const string &macrosLogPath)
+{
+    struct stat info;
+    bool existed = stat(mDataPath.c_str(), &info) == 0 && info.st_size >= HEADER_BYTES;
+
+    countFileOpen(mDataPath);
+    mFd = ::open(mDataPath.c_str(), O_RDWR | O_CREAT, 0644);
+    if (mFd < 0)
+        return false;
+
+    char header[HEADER_BYTES];
+    if (!existed)
+    {
+        memset(header, 0, sizeof(header));
+        memcpy(header, HISTORY_MAGIC, sizeof(HISTORY_MAGIC));
+        memcpy(header + 4, &HISTORY_VERSION, sizeof(HISTORY_VERSION));
+        if (ftruncate(mFd, 0) != 0 || pwrite(mFd, header, sizeof(header), 0) != (ssize_t)sizeof(header))
+            return false;
+        info.st_size = HEADER_BYTES;
+    }
+    else
+    {
+        uint32_t version = 0;
+        if (pread(mFd, header, sizeof(header), 0) != (ssize_t)sizeof(header))
+            return false;
+        memcpy(&version, header + 4, sizeof(version));
+        if (memcmp(header, HISTORY_MAGIC, sizeof(HISTORY_MAGIC)) != 0 || version != HISTORY_VERSION)
+        {
+            close(mFd);
+            mFd = -1;
+            return false;
+        }
+    }
+
+    mCount = (int)((info.st_size - HEADER_BYTES) / (off_t)sizeof(DayMacros));
+    if (recordOffset(mCount) != info.st_size)
+    {
+        // a record that was only partly written when the app went down
+        if (ftruncate(mFd, recordOffset(mCount)) != 0)
+            return false;
+    }
+    mLastDay = -1;
+    if (mCount > 0)
+    {
+        DayMacros last;
+        if (pread(mFd, &last, sizeof(last), recordOffset(mCount - 1)) == (ssize_t)sizeof(last))
+            mLastDay = last.day;
+    }
+
+    // the index is small, it's read whole and rebuilt from the data file if it doesn't match
+    mIndex.clear();
+    countFileOpen(mIndexPath);
+    std::ifstream index(mIndexPath, std::ios::binary);
+    pair<int32_t, int32_t> entry;
+    while (index.read(reinterpret_cast<char *>(&entry), sizeof(entry)))
+    {
+        mIndex.push_back(entry);
+    }
+    countBytesRead(mIndex.size() * sizeof(entry));
+    bool indexMatches = (int)mIndex.size() == (mCount + INDEX_STRIDE - 1) / INDEX_STRIDE;
+    for (int i = 0; indexMatches && i < (int)mIndex.size(); i++)
+    {
+        indexMatches = mIndex[i].second == i * INDEX_STRIDE;
+    }
+    if (!indexMatches)
+        rebuildIndex();
+
+    if (!existed)
+        importMacrosLog(macrosLogPath);
+    return true;
+}
+
+void MacroHistory::rebuildIndex()
+{
+    mIndex.clear();
+    for (int position = 0; position < mCount; position += INDEX_STRIDE)
+    {
+        DayMacros record;
+        if (pread(mFd, &record, sizeof(record), recordOffset(position)) != (ssize_t)sizeof(record))
+            break;
+        mIndex.emplace_back(record.day, position);
+    }
+    countFileOpen(mIndexPath);
+    std::ofstream index(mIndexPath, std::ios::binary | std::ios::trunc);
+    for (const auto &entry : mIndex)
+    {
+        index.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+    }
+    countBytesWritten(mIndex.size() * sizeof(pair<int32_t, int32_t>));
+}
+
+bool MacroHistory::importMacrosLog(const string &path)
+{
+    countFileOpen(path);
+    std::ifstream log(path);
+    if (!log.is_open())
+        return false;
+    string date = "", macros = "";
+    while (std::getline(log, date) && std::getline(log, macros))
+    {
+        countBytesRead(date.size() + macros.size() + 2);
+        DayMacros day;
+        day.day = epochDayFromCtime(date);
+        if (day.day < 0 || !parseMacros(macros, day))
+            continue;
+        append(day);
+    }
+    return true;
+}
+
+bool MacroHistory::writeRecord(int position, const DayMacros &day)
+{
+    countBytesWritten(sizeof(day));
+    return pwrite(mFd, &day, sizeof(day), recordOffset(position)) == (ssize_t)sizeof(day);
+}
+
+bool MacroHistory::append(const DayMacros &day)
+{
+    if (mFd < 0)
+        return false;
+    if (mCount > 0 && day.day == mLastDay)
+        return writeRecord(mCount - 1, day); // same day logged again, the newer totals win
+    if (mCount > 0 && day.day < mLastDay)
+        return false;
+
+    if (!writeRecord(mCount, day))
+        return false;
+    if (mCount % INDEX_STRIDE == 0)
+    {
+        pair<int32_t, int32_t> entry(day.day, mCount);
+        mIndex.push_back(entry);
+        countFileOpen(mIndexPath);
+        std::ofstream index(mIndexPath, std::ios::binary | std::ios::app);
+        index.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+        countBytesWritten(sizeof(entry));
+    }
+    mCount++;
+    mLastDay = day.day;
+    return true;
+}
+
+bool MacroHistory::merge(const vector<DayMacros> &days)
+{
+    if (mFd < 0)
+        return false;
+    if (days.empty())
+        return true;
+
+    vector<DayMacros> incoming = days;
+    std::sort(incoming.begin(), incoming.end(), [](const DayMacros &a, const DayMacros &b) { return a.day < b.day; });
+    vector<DayMacros> stored;
+    if (!readRecords(0, mCount, stored))
+        return false;
+
+    // both are in date order, walk them together
+    vector<DayMacros> merged;
+    merged.reserve(stored.size() + incoming.size());
+    size_t s = 0, i = 0;
+    while (s < stored.size() || i < incoming.size())
+    {
+        int day = (i == incoming.size() || (s < stored.size() && stored[s].day <= incoming[i].day)) ? stored[s].day : incoming[i].day;
+        DayMacros total;
+        memset(&total, 0, sizeof(total));
+        total.day = day;
+        for (; s < stored.size() && stored[s].day == day; s++)
+        {
+            total.calories += stored[s].calories;
+            total.protein += stored[s].protein;
+            total.carbs += stored[s].carbs;
+            total.fat += stored[s].fat;
+        }
+        for (; i < incoming.size() && incoming[i].day == day; i++)
+        {
+            total.calories += incoming[i].calories;
+            total.protein += incoming[i].protein;
+            total.carbs += incoming[i].carbs;
+            total.fat += incoming[i].fat;
+        }
+        merged.push_back(total);
+    }
+
+    // everything from the first day that changed onwards is written again in one go
+    int first = 0;
+    while (first < (int)stored.size() && memcmp(&stored[first], &merged[first], sizeof(DayMacros)) == 0)
+        first++;
+    size_t bytes = (merged.size() - first) * sizeof(DayMacros);
+    countBytesWritten(bytes);
+    if (bytes > 0 && pwrite(mFd, merged.data() + first, bytes, recordOffset(first)) != (ssize_t)bytes)
+        return false;
+    mCount = (int)merged.size();
+    mLastDay = merged.back().day;
+    rebuildIndex();
+    return true;
+}
+
+bool MacroHistory::readRecords(int first, int last, vector<DayMacros> &out) const
+{
+    if (first >= last)
+        return true;
+    size_t start = out.size();
+    out.resize(start + (last - first));
+    size_t bytes = (size_t)(last - first) * sizeof(DayMacros);
+    countBytesRead(bytes);
+    if (pread(mFd, out.data() + start, bytes, recordOffset(first)) != (ssize_t)bytes)
+    {
+        out.resize(start);
+        return false;
+    }
+    return true;
+}
+
+vector<DayMacros> MacroHistory::range(int firstDay, int lastDay) const
+{
+    vector<DayMacros> days;
+    if (mFd < 0 || mCount == 0 || firstDay > lastDay)
+        return days;
+
+    // last index block that starts on or before firstDay, and the first block that starts after lastDay
+    auto startBlock = std::partition_point(mIndex.begin(), mIndex.end(), [&](const pair<int32_t, int32_t> &entry) { return entry.first <= firstDay; });
+    int first = (startBlock == mIndex.begin()) ? 0 : (startBlock - 1)->second;
+    auto endBlock = std::partition_point(mIndex.begin(), mIndex.end(), [&](const pair<int32_t, int32_t> &entry) { return entry.first <= lastDay; });
+    int last = (endBlock == mIndex.end()) ? mCount : endBlock->second;
+
+    if (!readRecords(first, last, days))
+        return days;
+    auto begin = std::lower_bound(days.begin(), days.end(), firstDay, [](const DayMacros &day, int value) { return day.day < value; });
+    auto end = std::upper_bound(days.begin(), days.end(), lastDay, [](int value, const DayMacros &day) { return value < day.day; });
+    return vector<DayMacros>(begin, end);
+}
+
+vector<DayMacros> MacroHistory::lastDays(int count) const
+{
+    int today = epochDayToday();
+    if (count <= 0 || mIndex.empty())
+        return vector<DayMacros>();
+    // nothing before the first day logged, and today - count can't wrap around
+    count = std::min(count, std::max(today - mIndex.front().first + 1, 1));
+    return range(today - count + 1, today);
+}
+
+vector<DayMacros> MacroHistory::all() const
+{
+    vector<DayMacros> days;
+    if (mFd >= 0)
+        readRecords(0, mCount, days);
+    return days;
+}
+
+int MacroHistory::size() const
+{
+    return mCount;
+}
+
+int MacroHistory::lastDay() const
+{
+    return mLastDay;
+}
+
+bool MacroHistory::parseMacros(const string &line, DayMacros &day)
+{
+    // the four numbers follow the four colons, the labels have been spelled a few different ways over time
+    double values[4];
+    size_t position = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        position = line.find(':', position);
+        if (position == string::npos)
+            return false;
+        position++;
+        char *end = nullptr;
+        values[i] = strtod(line.c_str() + position, &end);
+        if (end == line.c_str() + position)
+            return false;
+    }
+    day.calories = (int32_t)values[0];
+    day.protein = values[1];
+    day.carbs = values[2];
+    day.fat = values[3];
+    return true;
+}
@@ -0,0 +1,66 @@
+//
+//  MacroHistory.hpp
+//  Meal Tracker
+//
+//  Daily macro totals keyed by epoch day. MacrosHistory.dat holds fixed size
+//  records sorted by day, MacrosHistory.idx holds the day of every 64th
+//  record. A date range is found with a binary search over that small index
+//  and then read from the data file in one go.
+//
+
+#ifndef MacroHistory_hpp
+#define MacroHistory_hpp
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdio.h>
+
+using std::string;
+using std::vector;
+using std::pair;
+
+
+struct DayMacros
+{
+    int32_t day; // epoch day
+    int32_t calories;
+    double protein;
+    double carbs;
+    double fat;
+};
+
+class MacroHistory
+{
+public:
+    MacroHistory(const string &dataPath = "MacrosHistory.dat", const string &indexPath = "MacrosHistory.idx");
+    ~MacroHistory();
+    MacroHistory(const MacroHistory &) = delete;
+    MacroHistory &operator=(const MacroHistory &) = delete;
+
+    bool open(const string &macrosLogPath = "MacrosLog.txt"); // a brand new history is filled from the old text log
+    bool importMacrosLog(const string &path);
+    bool append(const DayMacros &day); // replaces the last day if it is the same day, refuses days older than that
+    bool merge(const vector<DayMacros> &days); // adds the macros onto days already there and slots in new ones, any order
+
+    vector<DayMacros> range(int firstDay, int lastDay) const; // both ends included
+    vector<DayMacros> lastDays(int count) const; // the count calendar days up to and including today, none when count is below 1
+    vector<DayMacros> all() const;
+    int size() const;
+    int lastDay() const; // -1 when empty
+
+    static bool parseMacros(const string &line, DayMacros &day); // "Calories:1749  Protein:188  Carbs:123  Fats:54"
+
+private:
+    bool readRecords(int first, int last, vector<DayMacros> &out) const;
+    bool writeRecord(int position, const DayMacros &day);
+    void rebuildIndex();
+
+    string mDataPath;
+    string mIndexPath;
+    int mFd;
+    int mCount;
+    int mLastDay;
+    vector<pair<int32_t, int32_t> > mIndex; // day, record number of every 64th record
+};
+
+#endif /* MacroHistory_hpp */
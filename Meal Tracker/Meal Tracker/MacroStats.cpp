@@ -0,0 +1,180 @@
+//
+//  MacroStats.cpp
+//  Meal Tracker
+//
+
+#include "MacroStats.hpp"
+#include <algorithm>
+#include <cmath>
+
+static void valuesOf(const DayMacros &day, double values[4])
+{
+    values[CALORIES] = day.calories;
+    values[PROTEIN] = day.protein;
+    values[CARBS] = day.carbs;
+    values[FATS] = day.fat;
+}
+
+RunningStat::RunningStat()
+{
+    mCount = 0;
+    mMean = 0.0;
+    mM2 = 0.0;
+    mMin = 0.0;
+    mMax = 0.0;
+}
+
+void RunningStat::add(double value)
+{
+    mCount++;
+    double delta = value - mMean;
+    mMean += delta / mCount;
+    mM2 += delta * (value - mMean);
+    if (mCount == 1 || value < mMin)
+        mMin = value;
+    if (mCount == 1 || value > mMax)
+        mMax = value;
+}
+
+int RunningStat::count() const
+{
+    return mCount;
+}
+
+double RunningStat::mean() const
+{
+    return mMean;
+}
+
+double RunningStat::variance() const
+{
+    return mCount > 1 ? mM2 / (mCount - 1) : 0.0;
+}
+
+double RunningStat::stddev() const
+{
+    return sqrt(variance());
+}
+
+double RunningStat::min() const
+{
+    return mMin;
+}
+
+double RunningStat::max() const
+{
+    return mMax;
+}
+
+MacroStats::MacroStats()
+{
+    mWindows[0].days = 7;
+    mWindows[1].days = 30;
+    mWindows[2].days = 90;
+    clear();
+}
+
+MacroStats::~MacroStats()
+{
+
+}
+
+void MacroStats::clear()
+{
+    for (int n = 0; n < 4; n++)
+        mAllTime[n] = RunningStat();
+    for (Window &window : mWindows)
+    {
+        window.entries.clear();
+        for (int n = 0; n < 4; n++)
+        {
+            window.means[n] = 0.0;
+            window.m2[n] = 0.0;
+        }
+    }
+    mLatestDay = -1;
+}
+
+void MacroStats::addDay(const DayMacros &day)
+{
+    double values[4];
+    valuesOf(day, values);
+    for (int n = 0; n < 4; n++)
+        mAllTime[n].add(values[n]);
+
+    for (Window &window : mWindows)
+    {
+        window.entries.push_back(day);
+        double count = (double)window.entries.size();
+        for (int n = 0; n < 4; n++)
+        {
+            double delta = values[n] - window.means[n];
+            window.means[n] += delta / count;
+            window.m2[n] += delta * (values[n] - window.means[n]);
+        }
+        // drop the days that fell out of the window. A running sum of squares minus the old days loses the
+        // spread to rounding once the totals are big, Welford's update taken back doesn't
+        while (window.entries.front().day <= day.day - window.days)
+        {
+            double old[4];
+            valuesOf(window.entries.front(), old);
+            window.entries.pop_front();
+            count = (double)window.entries.size();
+            for (int n = 0; n < 4; n++)
+            {
+                if (count == 0.0)
+                {
+                    window.means[n] = 0.0;
+                    window.m2[n] = 0.0;
+                    continue;
+                }
+                double delta = old[n] - window.means[n];
+                window.means[n] -= delta / count;
+                window.m2[n] = std::max(window.m2[n] - delta * (old[n] - window.means[n]), 0.0);
+            }
+        }
+    }
+    mLatestDay = day.day;
+}
+
+const RunningStat &MacroStats::allTime(Nutrient nutrient) const
+{
+    return mAllTime[nutrient];
+}
+
+const MacroStats::Window *MacroStats::findWindow(int days) const
+{
+    for (const Window &window : mWindows)
+    {
+        if (window.days == days)
+            return &window;
+    }
+    return nullptr;
+}
+
+int MacroStats::windowCount(int days) const
+{
+    const Window *window = findWindow(days);
+    return window == nullptr ? 0 : (int)window->entries.size();
+}
+
+double MacroStats::windowMean(int days, Nutrient nutrient) const
+{
+    const Window *window = findWindow(days);
+    if (window == nullptr || window->entries.empty())
+        return 0.0;
+    return window->means[nutrient];
+}
+
+double MacroStats::windowStddev(int days, Nutrient nutrient) const
+{
+    const Window *window = findWindow(days);
+    if (window == nullptr || window->entries.size() < 2)
+        return 0.0;
+    return sqrt(window->m2[nutrient] / (window->entries.size() - 1));
+}
+
+int MacroStats::latestDay() const
+{
+    return mLatestDay;
+}
@@ -0,0 +1,72 @@
+//
+//  MacroStats.hpp
+//  Meal Tracker
+//
+//  Statistics over the closed days in the macro history. Everything is
+//  updated as a day is added so asking for a mean, spread or rolling
+//  average never walks the history again.
+//
+
+#ifndef MacroStats_hpp
+#define MacroStats_hpp
+#include "MacroHistory.hpp"
+#include <deque>
+#include <stdio.h>
+
+using std::deque;
+
+enum Nutrient { CALORIES = 0, PROTEIN = 1, CARBS = 2, FATS = 3 };
+
+// Welford's running mean and variance plus the smallest and largest value seen
+class RunningStat
+{
+public:
+    RunningStat();
+    void add(double value);
+    int count() const;
+    double mean() const;
+    double variance() const;
+    double stddev() const;
+    double min() const;
+    double max() const;
+
+private:
+    int mCount;
+    double mMean;
+    double mM2;
+    double mMin;
+    double mMax;
+};
+
+class MacroStats
+{
+public:
+    MacroStats();
+    ~MacroStats();
+
+    void clear();
+    void addDay(const DayMacros &day); // days have to come in date order
+
+    const RunningStat &allTime(Nutrient nutrient) const;
+    // Rolling windows cover the given number of calendar days ending on the latest day added, 7, 30 or 90
+    int windowCount(int days) const;
+    double windowMean(int days, Nutrient nutrient) const;
+    double windowStddev(int days, Nutrient nutrient) const;
+    int latestDay() const; // -1 before any day is added
+
+private:
+    struct Window
+    {
+        int days;
+        deque<DayMacros> entries;
+        double means[4]; // Welford's mean and sum of squared differences, run backwards for a day dropped
+        double m2[4];
+    };
+    const Window *findWindow(int days) const;
+
+    RunningStat mAllTime[4];
+    Window mWindows[3];
+    int mLatestDay;
+};
+
+#endif /* MacroStats_hpp */
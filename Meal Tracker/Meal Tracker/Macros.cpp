@@ -50,6 +50,14 @@ void Macros::setFats(double newFats)
     mFats = newFats;
 }
 
+void Macros::add(int calories, double protein, double carbs, double fats)
+{
+    mCalories += calories;
+    mProtein += protein;
+    mCarbs += carbs;
+    mFats += fats;
+}
+
 int Macros::getCalories() const
 {
     return mCalories;
@@ -30,6 +30,7 @@ class Macros
         void setProtein(double newProtein);
         void setCarbs(double newCarbs);
         void setFats(double newFats);
+        void add(int calories, double protein, double carbs, double fats);
         
         int getCalories() const;
         double getProteins() const;
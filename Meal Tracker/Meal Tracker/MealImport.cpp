@@ -0,0 +1,346 @@
+//
+//  MealImport.cpp
+//  Meal Tracker
+//
+
+#include "MealImport.hpp"
+#include "FileScan.hpp"
+#include "NutrientTable.hpp"
+#include "Json.hpp"
+#include "Dates.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+static const size_t MAX_BAD_LINES = 10;
+static const double MAX_AMOUNT = 100000.0; // grams or servings, past this a row is a typo
+
+static string_view trim(const char *first, const char *last)
+{
+    while (first < last && (*first == ' ' || *first == '\t'))
+        first++;
+    while (last > first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r'))
+        last--;
+    return string_view(first, last - first);
+}
+
+// Reads a number that has to fill the whole field, an empty field counts as not given. The journal keeps
+// whole grams and servings, so the amount is rounded here and the macros are worked out from what is kept
+static bool parseAmount(string_view text, double &value, bool &given)
+{
+    given = !text.empty();
+    if (!given)
+        return true;
+    double parsed = 0.0;
+    const char *end = text.data() + text.size();
+    if (!parseDouble(text.data(), end, parsed) || parsed < 0.0 || parsed > MAX_AMOUNT)
+        return false;
+    value = round(parsed);
+    return true;
+}
+
+MealImport::MealImport()
+{
+
+}
+
+MealImport::~MealImport()
+{
+
+}
+
+bool MealImport::read(const string &path, const DictionarySnapshot &dictionary)
+{
+    if (path == "-")
+    {
+        string text;
+        char buffer[1 << 16];
+        size_t count;
+        while ((count = fread(buffer, 1, sizeof(buffer), stdin)) > 0)
+            text.append(buffer, count);
+        parse(text.data(), text.data() + text.size(), dictionary);
+        return true;
+    }
+    MappedFile file(path);
+    if (!file.isOpen())
+        return false;
+    parse(file.data(), file.data() + file.size(), dictionary);
+    return true;
+}
+
+void MealImport::parse(const char *first, const char *last, const DictionarySnapshot &dictionary)
+{
+    mEntries.clear();
+    mReport = ImportReport();
+
+    vector<Row> rows;
+    rows.reserve((last - first) / 32);
+    unordered_map<string, int> resolved; // name as written -> dictionary position, -1 when it isn't there
+    unordered_map<string, int> unknown; // name -> index into mReport.unknownFoods
+    string key;
+
+    int lineNumber = 0;
+    bool seenData = false;
+    const char *at = first;
+    while (at < last)
+    {
+        const char *end = static_cast<const char *>(memchr(at, '\n', last - at));
+        if (end == nullptr)
+            end = last;
+        lineNumber++;
+        string_view line = trim(at, end);
+        at = end + 1;
+        if (line.empty())
+            continue;
+
+        Row row;
+        string_view name;
+        bool json = line.front() == '{';
+        if (!seenData && !json && (line.compare(0, 4, "time") == 0 || line.compare(0, 4, "Time") == 0))
+        {
+            // the header
+            seenData = true;
+            continue;
+        }
+        seenData = true;
+        mReport.lines++;
+        const char *lineEnd = line.data() + line.size();
+        bool ok = json ? parseJson(line.data(), lineEnd, row, name) : parseCsv(line.data(), lineEnd, row, name);
+        if (!ok || name.empty())
+        {
+            markBad(lineNumber);
+            continue;
+        }
+
+        key.assign(name.data(), name.size());
+        auto found = resolved.find(key);
+        if (found == resolved.end())
+            found = resolved.emplace(key, dictionary.find(key)).first;
+        row.food = found->second;
+        if (row.food < 0)
+        {
+            auto seen = unknown.find(key);
+            if (seen == unknown.end())
+            {
+                unknown.emplace(key, (int)mReport.unknownFoods.size());
+                mReport.unknownFoods.push_back(pair<string, int>(key, 1));
+            }
+            else
+                mReport.unknownFoods[seen->second].second++;
+            continue;
+        }
+
+        // foods listed by weight need grams, the rest need servings
+        const Food &food = dictionary.food(row.food);
+        bool byWeight = food.getGrams() != 0;
+        if ((byWeight && row.grams < 0.0) || (!byWeight && (row.servings < 0.0 || food.getServings() == 0)))
+        {
+            markBad(lineNumber);
+            continue;
+        }
+        rows.push_back(row);
+    }
+    compute(rows, dictionary);
+}
+
+void MealImport::markBad(int line)
+{
+    mReport.malformed++;
+    if (mReport.badLines.size() < MAX_BAD_LINES)
+        mReport.badLines.push_back(line);
+}
+
+// timestamp,food,grams,servings. The name may be in double quotes, "" inside them is a quote
+bool MealImport::parseCsv(const char *first, const char *last, Row &row, string_view &name)
+{
+    const char *comma = static_cast<const char *>(memchr(first, ',', last - first));
+    if (comma == nullptr || !parseTimestamp(trim(first, comma), row.timestamp))
+        return false;
+
+    const char *at = comma + 1;
+    while (at < last && *at == ' ')
+        at++;
+    if (at < last && *at == '"')
+    {
+        mUnquoted.clear();
+        at++;
+        while (at < last)
+        {
+            if (*at == '"')
+            {
+                if (at + 1 < last && at[1] == '"')
+                {
+                    mUnquoted += '"';
+                    at += 2;
+                    continue;
+                }
+                break;
+            }
+            mUnquoted += *at++;
+        }
+        if (at >= last)
+            return false;
+        at++;
+        while (at < last && *at == ' ')
+            at++;
+        if (at >= last || *at != ',')
+            return false;
+        name = mUnquoted;
+    }
+    else
+    {
+        comma = static_cast<const char *>(memchr(at, ',', last - at));
+        if (comma == nullptr)
+            return false;
+        name = trim(at, comma);
+        at = comma;
+    }
+
+    // at is on the comma before grams
+    at++;
+    comma = static_cast<const char *>(memchr(at, ',', last - at));
+    const char *gramsEnd = comma == nullptr ? last : comma;
+    const char *servingsStart = comma == nullptr ? last : comma + 1;
+    bool gramsGiven = false, servingsGiven = false;
+    row.grams = -1.0;
+    row.servings = -1.0;
+    if (!parseAmount(trim(at, gramsEnd), row.grams, gramsGiven) || !parseAmount(trim(servingsStart, last), row.servings, servingsGiven))
+        return false;
+    if (servingsStart < last && memchr(servingsStart, ',', last - servingsStart) != nullptr)
+        return false; // more columns than there should be
+    return gramsGiven || servingsGiven;
+}
+
+// {"time": ..., "food": "...", "grams": ..., "servings": ...}
+bool MealImport::parseJson(const char *first, const char *last, Row &row, string_view &name)
+{
+    mFields.clear();
+    if (!parseJsonObject(string(first, last), mFields))
+        return false;
+
+    auto time = mFields.find("time");
+    if (time == mFields.end())
+        time = mFields.find("timestamp");
+    auto food = mFields.find("food");
+    if (time == mFields.end() || food == mFields.end() || !parseTimestamp(time->second, row.timestamp))
+        return false;
+    name = food->second;
+
+    row.grams = -1.0;
+    row.servings = -1.0;
+    bool gramsGiven = false, servingsGiven = false;
+    auto grams = mFields.find("grams");
+    if (grams != mFields.end() && !parseAmount(grams->second, row.grams, gramsGiven))
+        return false;
+    auto servings = mFields.find("servings");
+    if (servings != mFields.end() && !parseAmount(servings->second, row.servings, servingsGiven))
+        return false;
+    return gramsGiven || servingsGiven;
+}
+
+bool MealImport::parseTimestamp(string_view text, int64_t &timestamp)
+{
+    if (text.empty())
+        return false;
+    const char *first = text.data();
+    const char *last = first + text.size();
+
+    // epoch seconds
+    if (text.size() < 10 || text[4] != '-')
+    {
+        for (char ch : text)
+        {
+            if (ch < '0' || ch > '9')
+                return false;
+        }
+        double seconds = 0.0;
+        if (!parseDouble(first, last, seconds))
+            return false;
+        timestamp = (int64_t)seconds;
+        return true;
+    }
+
+    // 2025-04-08, then optionally T or a space and 09:30 or 09:30:15
+    int year = 0, month = 0, day = 0;
+    if (text[7] != '-' || !parseInt(first, first + 4, year) || !parseInt(first + 5, first + 7, month) || !parseInt(first + 8, first + 10, day))
+        return false;
+    if (month < 1 || month > 12 || day < 1 || day > 31)
+        return false;
+    int64_t seconds = 12 * 3600; // just a date is taken as noon
+    if (text.size() > 10)
+    {
+        int hour = 0, minute = 0, second = 0;
+        if ((text[10] != 'T' && text[10] != ' ') || text.size() < 16 || text[13] != ':')
+            return false;
+        if (!parseInt(first + 11, first + 13, hour) || !parseInt(first + 14, first + 16, minute))
+            return false;
+        if (text.size() > 16 && (text.size() != 19 || text[16] != ':' || !parseInt(first + 17, first + 19, second)))
+            return false;
+        if (hour > 23 || minute > 59 || second > 60)
+            return false;
+        seconds = hour * 3600 + minute * 60 + second;
+    }
+
+    string date(first, 10);
+    auto cached = mMidnights.find(date);
+    if (cached == mMidnights.end())
+    {
+        time_t midnight = startOfDay(year, month, day);
+        if (midnight == (time_t)-1)
+            return false;
+        cached = mMidnights.emplace(date, midnight).first;
+    }
+    timestamp = (int64_t)cached->second + seconds;
+    return true;
+}
+
+// Each row's macros are the dictionary food's macros times how much of it was eaten, done a column at a time
+void MealImport::compute(const vector<Row> &rows, const DictionarySnapshot &dictionary)
+{
+    size_t count = rows.size();
+    vector<double> ratio(count), calories(count), protein(count), carbs(count), fat(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const Food &food = dictionary.food(rows[i].food);
+        ratio[i] = food.getGrams() == 0 ? rows[i].servings / (double)food.getServings() : rows[i].grams / (double)food.getGrams();
+        calories[i] = food.getCal();
+        protein[i] = food.getProtein();
+        carbs[i] = food.getCarb();
+        fat[i] = food.getFat();
+    }
+    multiplyColumns(calories.data(), ratio.data(), count);
+    multiplyColumns(protein.data(), ratio.data(), count);
+    multiplyColumns(carbs.data(), ratio.data(), count);
+    multiplyColumns(fat.data(), ratio.data(), count);
+
+    mEntries.resize(count);
+    vector<uint32_t> nameIds(dictionary.size(), UINT32_MAX); // dictionary position -> name id
+    for (size_t i = 0; i < count; i++)
+    {
+        const Food &food = dictionary.food(rows[i].food);
+        uint32_t &nameId = nameIds[rows[i].food];
+        if (nameId == UINT32_MAX)
+            nameId = foodNames().intern(food.getName());
+        bool byWeight = food.getGrams() != 0;
+        JournalEntry &entry = mEntries[i];
+        entry.timestamp = rows[i].timestamp;
+        entry.nameId = nameId;
+        entry.grams = byWeight ? (int)rows[i].grams : 0;
+        entry.servings = byWeight ? 0 : (int)rows[i].servings;
+        entry.calories = (int)std::min(calories[i], (double)INT_MAX); // a food with huge calories per gram
+        entry.protein = protein[i];
+        entry.carbs = carbs[i];
+        entry.fat = fat[i];
+    }
+}
+
+const vector<JournalEntry> &MealImport::entries() const
+{
+    return mEntries;
+}
+
+const ImportReport &MealImport::report() const
+{
+    return mReport;
+}
@@ -0,0 +1,72 @@
+//
+//  MealImport.hpp
+//  Meal Tracker
+//
+//  Turns a file of eaten foods into journal entries without asking anything.
+//  Lines are either CSV, "timestamp,food,grams,servings" with an optional
+//  header, or one JSON object per line with the same fields ("time" works
+//  too). Timestamps are epoch seconds, "2025-04-08" (taken as noon) or
+//  "2025-04-08T09:30[:00]", in local time. Every distinct name is looked up
+//  in the dictionary once, then the macros for all rows are worked out a
+//  column at a time.
+//
+
+#ifndef MealImport_hpp
+#define MealImport_hpp
+#include "FoodDictionary.hpp"
+#include "MealJournal.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <ctime>
+#include <stdio.h>
+
+using std::string;
+using std::string_view;
+using std::vector;
+using std::unordered_map;
+using std::pair;
+
+struct ImportReport
+{
+    int lines = 0; // not counting blank lines and the header
+    int malformed = 0;
+    vector<int> badLines; // the first few malformed line numbers
+    vector<pair<string, int> > unknownFoods; // names not in the dictionary and how many rows used them
+};
+
+class MealImport
+{
+public:
+    MealImport();
+    ~MealImport();
+
+    bool read(const string &path, const DictionarySnapshot &dictionary); // "-" reads stdin, false if the file can't be opened
+    void parse(const char *first, const char *last, const DictionarySnapshot &dictionary);
+
+    const vector<JournalEntry> &entries() const; // in the order they appeared
+    const ImportReport &report() const;
+
+private:
+    struct Row
+    {
+        int64_t timestamp;
+        int food; // dictionary position
+        double grams;
+        double servings;
+    };
+    bool parseCsv(const char *first, const char *last, Row &row, string_view &name);
+    bool parseJson(const char *first, const char *last, Row &row, string_view &name);
+    bool parseTimestamp(string_view text, int64_t &timestamp);
+    void markBad(int line);
+    void compute(const vector<Row> &rows, const DictionarySnapshot &dictionary);
+
+    vector<JournalEntry> mEntries;
+    ImportReport mReport;
+    unordered_map<string, time_t> mMidnights; // "2025-04-08" -> local midnight, mktime is slow
+    unordered_map<string, string> mFields; // reused for every JSON line
+    string mUnquoted; // scratch for CSV names with quotes in them
+};
+
+#endif /* MealImport_hpp */
@@ -0,0 +1,471 @@
+//
+//  MealJournal.cpp
+//  Meal Tracker
+//
+
+#include "MealJournal.hpp"
+#include "SessionStats.hpp"
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const uint32_t JOURNAL_MAGIC = 0x314A544D; // "MTJ1" on disk
+static const uint16_t JOURNAL_VERSION = 2; // version 1 entries stand alone, from 2 on they belong to a numbered commit
+static const uint32_t LAST_IN_COMMIT = 0x80000000u;
+
+// What sits on disk in front of every name, 64 bytes
+struct JournalRecord
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t nameLength;
+    int64_t timestamp;
+    uint32_t foodId;
+    int32_t grams;
+    int32_t servings;
+    int32_t calories;
+    double protein;
+    double carbs;
+    double fat;
+    uint32_t checksum; // crc32 of this record with checksum set to 0, then the name
+    uint32_t sequence; // position in its commit, LAST_IN_COMMIT is set on the last one
+};
+
+struct CrcTable
+{
+    uint32_t entries[256];
+    CrcTable()
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; bit++)
+                value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+            entries[i] = value;
+        }
+    }
+};
+
+static uint32_t crc32(uint32_t crc, const void *data, size_t length)
+{
+    static const CrcTable table; // built once, safely, by whichever thread gets here first
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++)
+        crc = table.entries[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static uint32_t checksumOf(JournalRecord record, const char *name)
+{
+    record.checksum = 0;
+    uint32_t crc = crc32(0, &record, sizeof(record));
+    return crc32(crc, name, record.nameLength);
+}
+
+MealJournal::MealJournal(const string &path)
+{
+    mPath = path;
+    mWriting = false;
+    mFd = -1;
+    mEnd = -1;
+    mPolicy = SYNC_COMMIT;
+    mIntervalMs = 1000;
+    mLastSync = std::chrono::steady_clock::now();
+    mUnsynced = false;
+    mFailed = false;
+}
+
+MealJournal::~MealJournal()
+{
+    flush();
+    if (mFd >= 0)
+    {
+        if (mUnsynced)
+            fsync(mFd);
+        close(mFd);
+    }
+}
+
+void MealJournal::setSyncPolicy(SyncPolicy policy, int intervalMs)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    mPolicy = policy;
+    mIntervalMs = intervalMs;
+}
+
+const string &MealJournal::path() const
+{
+    return mPath;
+}
+
+bool MealJournal::exists() const
+{
+    struct stat info;
+    return stat(mPath.c_str(), &info) == 0;
+}
+
+uint32_t MealJournal::foodIdFor(const string &name)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (char ch : name)
+    {
+        hash ^= (unsigned char)std::tolower(static_cast<unsigned char>(ch));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Adds one entry in its on disk form to the end of buffer
+static void encode(string &buffer, uint32_t sequence, const string &fullName, int64_t timestamp, int grams, int servings, int calories, double protein, double carbs, double fat)
+{
+    string name = fullName;
+    if (name.size() > UINT16_MAX)
+        name.resize(UINT16_MAX);
+
+    JournalRecord record;
+    memset(&record, 0, sizeof(record));
+    record.magic = JOURNAL_MAGIC;
+    record.version = JOURNAL_VERSION;
+    record.nameLength = (uint16_t)name.size();
+    record.timestamp = timestamp;
+    record.foodId = MealJournal::foodIdFor(name);
+    record.grams = grams;
+    record.servings = servings;
+    record.calories = calories;
+    record.protein = protein;
+    record.carbs = carbs;
+    record.fat = fat;
+    record.sequence = sequence;
+    record.checksum = checksumOf(record, name.data());
+
+    buffer.append(reinterpret_cast<const char *>(&record), sizeof(record));
+    buffer.append(name);
+}
+
+static uint32_t sequenceOf(size_t i, size_t count)
+{
+    return (uint32_t)i | (i + 1 == count ? LAST_IN_COMMIT : 0);
+}
+
+static string encodeAll(const vector<JournalEntry> &entries)
+{
+    string buffer;
+    buffer.reserve(entries.size() * (sizeof(JournalRecord) + 24));
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        const JournalEntry &entry = entries[i];
+        encode(buffer, sequenceOf(i, entries.size()), entry.name(), entry.timestamp, entry.grams, entry.servings, entry.calories, entry.protein, entry.carbs, entry.fat);
+    }
+    return buffer;
+}
+
+bool MealJournal::append(vector<Food> &foods, time_t when)
+{
+    if (foods.empty())
+        return true;
+    return wait(submit(foods, when));
+}
+
+bool MealJournal::append(const vector<JournalEntry> &entries)
+{
+    if (entries.empty())
+        return true;
+    return wait(submitBuffer(encodeAll(entries)));
+}
+
+shared_ptr<JournalCommit> MealJournal::submit(vector<Food> &foods, time_t when)
+{
+    string buffer;
+    for (size_t i = 0; i < foods.size(); i++)
+    {
+        const Food &food = foods[i];
+        encode(buffer, sequenceOf(i, foods.size()), food.getName(), (int64_t)when, food.getGrams(), food.getServings(), food.getCal(), food.getProtein(), food.getCarb(), food.getFat());
+    }
+    return submitBuffer(buffer);
+}
+
+static int64_t fileSize(const string &path)
+{
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? (int64_t)info.st_size : 0;
+}
+
+shared_ptr<JournalCommit> MealJournal::submitBuffer(const string &buffer)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    if (mFailed)
+    {
+        shared_ptr<JournalCommit> refused = std::make_shared<JournalCommit>();
+        refused->ok = false;
+        refused->done = true;
+        return refused;
+    }
+    if (mEnd < 0)
+        mEnd = fileSize(mPath) + (int64_t)mPending.size();
+    if (!mPendingCommit)
+        mPendingCommit = std::make_shared<JournalCommit>();
+    mPending += buffer;
+    mEnd += (int64_t)buffer.size();
+    return mPendingCommit;
+}
+
+// Whoever waits while nobody is writing becomes the writer and takes every commit pending, its own included
+bool MealJournal::wait(const shared_ptr<JournalCommit> &commit)
+{
+    std::unique_lock<std::mutex> lock(mLock);
+    while (!commit->done)
+    {
+        if (mWriting || !mPendingCommit)
+        {
+            mWritten.wait(lock);
+            continue;
+        }
+        string buffer;
+        buffer.swap(mPending);
+        shared_ptr<JournalCommit> group = mPendingCommit;
+        mPendingCommit.reset();
+        mWriting = true;
+        lock.unlock();
+
+        // only the writer touches the descriptor and the sync state
+        ScopedTimer timer("MealJournal::write");
+        bool ok = openForAppend() && writeOut(mFd, buffer);
+        auto now = std::chrono::steady_clock::now();
+        if (ok && mPolicy == SYNC_COMMIT)
+            ok = fsync(mFd) == 0;
+        else if (ok && mPolicy == SYNC_PERIODIC)
+        {
+            mUnsynced = true;
+            if (now - mLastSync >= std::chrono::milliseconds(mIntervalMs))
+            {
+                ok = fsync(mFd) == 0;
+                mLastSync = now;
+                mUnsynced = false;
+            }
+        }
+
+        lock.lock();
+        mWriting = false;
+        if (!ok)
+        {
+            mEnd = -1; // what made it to the file is unknown, look again next time
+            // the commits behind it would land after a hole, they fail with it
+            mFailed = true;
+            if (mPendingCommit)
+            {
+                mPendingCommit->ok = false;
+                mPendingCommit->done = true;
+                mPendingCommit.reset();
+                mPending.clear();
+            }
+        }
+        group->ok = ok;
+        group->done = true;
+        mWritten.notify_all();
+    }
+    return commit->ok;
+}
+
+bool MealJournal::finished(const shared_ptr<JournalCommit> &commit, bool &ok)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    ok = commit->ok;
+    return commit->done;
+}
+
+void MealJournal::recover()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    mFailed = false;
+}
+
+bool MealJournal::flush()
+{
+    shared_ptr<JournalCommit> last;
+    {
+        std::unique_lock<std::mutex> lock(mLock);
+        last = mPendingCommit;
+        if (!last)
+        {
+            mWritten.wait(lock, [this] { return !mWriting; });
+            return true;
+        }
+    }
+    return wait(last);
+}
+
+int64_t MealJournal::size()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    if (mEnd < 0)
+        mEnd = fileSize(mPath) + (int64_t)mPending.size();
+    return mEnd;
+}
+
+bool MealJournal::replaceAll(const vector<JournalEntry> &entries)
+{
+    flush();
+    std::lock_guard<std::mutex> lock(mLock);
+    // a crash before the rename leaves the old journal as it was
+    string next = mPath + ".new";
+    countFileOpen(next);
+    int fd = open(next.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+    bool ok = writeOut(fd, encodeAll(entries)) && fsync(fd) == 0;
+    ok = (close(fd) == 0) && ok;
+    if (!ok || rename(next.c_str(), mPath.c_str()) != 0)
+        return false;
+    // the descriptor still points at the old file
+    if (mFd >= 0)
+        close(mFd);
+    mFd = -1;
+    mEnd = -1;
+    mUnsynced = false;
+    return true;
+}
+
+bool MealJournal::openForAppend()
+{
+    if (mFd >= 0)
+        return true;
+    countFileOpen(mPath);
+    mFd = open(mPath.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    return mFd >= 0;
+}
+
+bool MealJournal::writeOut(int fd, const string &buffer)
+{
+    size_t written = 0;
+    while (written < buffer.size())
+    {
+        ssize_t result = write(fd, buffer.data() + written, buffer.size() - written);
+        if (result < 0)
+            return false;
+        written += (size_t)result;
+    }
+    countBytesWritten(written);
+    return true;
+}
+
+vector<JournalEntry> MealJournal::readAll() const
+{
+    return readFrom(0);
+}
+
+vector<JournalEntry> MealJournal::readFrom(int64_t offset) const
+{
+    vector<JournalEntry> entries;
+    countFileOpen(mPath);
+    std::ifstream in(mPath, std::ios::binary);
+    if (!in.is_open())
+        return entries;
+    in.seekg(offset);
+    if (!in)
+        return entries;
+    string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    countBytesRead(data.size());
+
+    vector<JournalEntry> commit; // the foods of the commit being read, kept once its last one turns up
+    bool broken = false; // part of the commit is missing, drop the rest of it
+    size_t at = 0;
+    while (at + sizeof(JournalRecord) <= data.size())
+    {
+        JournalRecord record;
+        memcpy(&record, data.data() + at, sizeof(record));
+        size_t nameStart = at + sizeof(JournalRecord);
+        bool valid = record.magic == JOURNAL_MAGIC && (record.version == 1 || record.version == JOURNAL_VERSION)
+            && nameStart + record.nameLength <= data.size()
+            && record.checksum == checksumOf(record, data.data() + nameStart);
+        if (!valid)
+        {
+            // torn or damaged entry, look for the next one that starts cleanly
+            at++;
+            continue;
+        }
+
+        JournalEntry entry;
+        entry.timestamp = record.timestamp;
+        entry.grams = record.grams;
+        entry.servings = record.servings;
+        entry.calories = record.calories;
+        entry.protein = record.protein;
+        entry.carbs = record.carbs;
+        entry.fat = record.fat;
+        entry.nameId = foodNames().intern(string_view(data.data() + nameStart, record.nameLength));
+        at = nameStart + record.nameLength;
+
+        if (record.version == 1)
+        {
+            entries.push_back(std::move(entry));
+            continue;
+        }
+        uint32_t position = record.sequence & ~LAST_IN_COMMIT;
+        if (position == 0)
+        {
+            // a new commit, whatever was left of the one before it never finished
+            commit.clear();
+            broken = false;
+        }
+        else if (broken || position != commit.size())
+        {
+            broken = true;
+            continue;
+        }
+        commit.push_back(std::move(entry));
+        if (record.sequence & LAST_IN_COMMIT)
+        {
+            std::move(commit.begin(), commit.end(), std::back_inserter(entries));
+            commit.clear();
+        }
+    }
+    return entries;
+}
+
+void MealJournal::exportText(ostream &out) const
+{
+    vector<JournalEntry> entries = readAll();
+    int totalCal = 0;
+    double totalPro = 0.0, totalCarb = 0.0, totalFat = 0.0;
+    int currentYear = -1, currentDay = -1;
+
+    size_t i = 0;
+    while (i < entries.size())
+    {
+        time_t when = (time_t)entries[i].timestamp;
+        struct tm local;
+        localtime_r(&when, &local);
+        if (local.tm_year != currentYear || local.tm_yday != currentDay)
+        {
+            // the totals in FoodLog.txt always ran from the start of the day
+            currentYear = local.tm_year;
+            currentDay = local.tm_yday;
+            totalCal = 0;
+            totalPro = totalCarb = totalFat = 0.0;
+        }
+
+        char date[32];
+        strftime(date, sizeof(date), "%a %b %e %H:%M:%S %Y", &local);
+        out << "Date: " << date << std::endl;
+        // every food written by one append shares its timestamp
+        for (; i < entries.size() && entries[i].timestamp == (int64_t)when; i++)
+        {
+            const JournalEntry &entry = entries[i];
+            Food food(entry.name(), entry.grams, entry.servings, entry.calories, entry.protein, entry.carbs, entry.fat);
+            out << food << std::endl;
+            totalCal += entry.calories;
+            totalPro += entry.protein;
+            totalCarb += entry.carbs;
+            totalFat += entry.fat;
+        }
+        out << "Todays Totals:" << std::endl << "Calories:" << totalCal << "  Protein:" << round(totalPro) << "  Carbs:" << round(totalCarb) << "  Fats:" << round(totalFat) << std::endl;
+        out << "----------------------------------------------------------------------------------" << std::endl;
+    }
+}
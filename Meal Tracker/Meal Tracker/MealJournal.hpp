@@ -0,0 +1,115 @@
+//
+//  MealJournal.hpp
+//  Meal Tracker
+//
+//  Append only record of every food logged, and the app's write ahead log:
+//  a food counts as logged once its commit is in here, DayTotals.txt and
+//  DayFoods.txt are only checkpoints rebuilt from the tail after a crash.
+//  Each entry is a fixed size header (time, food id, amounts, macros,
+//  checksum) followed by the name. The foods of one commit are numbered and
+//  the last one is marked, so readers drop a commit that was cut off part
+//  way and skip a damaged entry to pick up at the next good one.
+//  Commits that arrive while another is being written are written and
+//  synced together with it. FoodLog.txt is rendered from here on demand.
+//
+
+#ifndef MealJournal_hpp
+#define MealJournal_hpp
+#include "Food.hpp"
+#include "NamePool.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <stdio.h>
+
+using std::string;
+using std::vector;
+using std::ostream;
+using std::shared_ptr;
+
+// When a commit is pushed to the disk
+enum SyncPolicy
+{
+    SYNC_COMMIT, // fsync before a commit returns, the default
+    SYNC_PERIODIC, // fsync at most once per interval, a power cut can lose the commits since the last one
+    SYNC_NONE // leave it to the OS, only a process crash is survived
+};
+
+// One group of commits on its way to the disk
+struct JournalCommit
+{
+    bool done = false;
+    bool ok = true;
+};
+
+
+// A logged food as plain data, 48 bytes, the name lives in foodNames()
+struct JournalEntry
+{
+    int64_t timestamp;
+    uint32_t nameId;
+    int32_t grams;
+    int32_t servings;
+    int32_t calories;
+    double protein;
+    double carbs;
+    double fat;
+
+    const string &name() const { return foodNames().name(nameId); }
+};
+
+class MealJournal
+{
+public:
+    MealJournal(const string &path = "FoodLog.journal");
+    ~MealJournal();
+
+    MealJournal(const MealJournal &) = delete;
+    MealJournal &operator=(const MealJournal &) = delete;
+
+    bool append(vector<Food> &foods, time_t when); // all foods go out in one write, stamped with the same time
+    bool append(const vector<JournalEntry> &entries); // same, each entry keeps its own time and the food id is worked out again
+    // append() is submit() then wait(), the wait can happen without holding whatever lock the submit needed
+    shared_ptr<JournalCommit> submit(vector<Food> &foods, time_t when);
+    bool wait(const shared_ptr<JournalCommit> &commit);
+    bool finished(const shared_ptr<JournalCommit> &commit, bool &ok); // without waiting, ok says if the write worked
+    void recover(); // after a failed write, once the caller knows what to submit again
+    bool flush(); // waits for everything submitted so far
+    bool replaceAll(const vector<JournalEntry> &entries); // writes a new journal beside this one and renames it over
+    vector<JournalEntry> readAll() const;
+    vector<JournalEntry> readFrom(int64_t offset) const; // entries at or after a byte offset, see size()
+    int64_t size(); // where the next commit will start, counting the ones still waiting to be written
+
+    void setSyncPolicy(SyncPolicy policy, int intervalMs = 1000);
+    void exportText(ostream &out) const; // the old FoodLog.txt layout, one block per append
+    bool exists() const;
+    const string &path() const;
+
+    static uint32_t foodIdFor(const string &name); // stable id from the case folded name
+
+private:
+    shared_ptr<JournalCommit> submitBuffer(const string &buffer);
+    bool writeOut(int fd, const string &buffer);
+    bool openForAppend();
+
+    string mPath;
+    std::mutex mLock;
+    std::condition_variable mWritten;
+    string mPending; // commits waiting for the writer
+    shared_ptr<JournalCommit> mPendingCommit; // shared by everything in mPending
+    bool mWriting; // a committer is writing outside the lock
+    int mFd; // kept open for appending, -1 until the first commit
+    int64_t mEnd; // size of the file plus what is pending, -1 until known
+    SyncPolicy mPolicy;
+    int mIntervalMs;
+    std::chrono::steady_clock::time_point mLastSync;
+    bool mUnsynced; // written but not fsynced yet
+    bool mFailed; // a write failed, submits fail straight away until recover() so nothing lands past the hole
+};
+
+#endif /* MealJournal_hpp */
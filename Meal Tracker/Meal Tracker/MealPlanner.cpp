@@ -0,0 +1,308 @@
+//
+//  MealPlanner.cpp
+//  Meal Tracker
+//
+
+#include "MealPlanner.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+typedef std::chrono::steady_clock Clock;
+
+// a food the planner can use, with its macros for one gram or one serving
+struct Candidate
+{
+    int position;
+    bool byGrams;
+    double perUnit[4];
+    double step; // amounts tried while branching, step, 2 * step, ...
+    int steps;
+    double fineStep; // the last food's amount is rounded to this
+    double score; // how close this food gets alone, used to order the search
+};
+
+// error is sum over macros of ((goal - total) / scale)^2
+struct Goal
+{
+    double target[4];
+    double weight[4]; // 1 / scale^2
+};
+
+static double missOf(const Goal &goal, const double total[4])
+{
+    double miss = 0.0;
+    for (int n = 0; n < 4; n++)
+    {
+        double d = goal.target[n] - total[n];
+        miss += d * d * goal.weight[n];
+    }
+    return miss;
+}
+
+// only overshoot counts, adding more food can fill a shortfall but never undo going over
+static double overshootOf(const Goal &goal, const double total[4])
+{
+    double miss = 0.0;
+    for (int n = 0; n < 4; n++)
+    {
+        double d = total[n] - goal.target[n];
+        if (d > 0)
+            miss += d * d * goal.weight[n];
+    }
+    return miss;
+}
+
+// amount of the food that gets closest to the goal on top of total, on the food's fine step
+static double bestAmount(const Goal &goal, const Candidate &food, const double total[4])
+{
+    double top = 0.0, bottom = 0.0;
+    for (int n = 0; n < 4; n++)
+    {
+        top += (goal.target[n] - total[n]) * food.perUnit[n] * goal.weight[n];
+        bottom += food.perUnit[n] * food.perUnit[n] * goal.weight[n];
+    }
+    if (bottom <= 0.0)
+        return 0.0;
+    double amount = round((top / bottom) / food.fineStep) * food.fineStep;
+    return std::min(std::max(amount, food.fineStep), food.step * food.steps);
+}
+
+static void addAmount(const Candidate &food, double amount, const double total[4], double out[4])
+{
+    for (int n = 0; n < 4; n++)
+        out[n] = total[n] + food.perUnit[n] * amount;
+}
+
+struct SharedSearch
+{
+    const vector<Candidate> *pool;
+    Goal goal;
+    int maxFoods;
+    Clock::time_point deadline;
+    std::atomic<int> nextFirst;
+    std::atomic<bool> stop;
+    std::atomic<double> best;
+    std::atomic<long long> nodes;
+};
+
+class Worker
+{
+public:
+    Worker(SharedSearch &shared) : mShared(shared)
+    {
+        mBest = std::numeric_limits<double>::infinity();
+        mNodes = 0;
+    }
+
+    void run()
+    {
+        const vector<Candidate> &pool = *mShared.pool;
+        double empty[4] = {0.0, 0.0, 0.0, 0.0};
+        for (int first = mShared.nextFirst++; first < (int)pool.size() && !mShared.stop; first = mShared.nextFirst++)
+            tryFood(0, first, empty);
+        mShared.nodes += mNodes;
+    }
+
+    double mBest;
+    vector<std::pair<int, double> > mBestItems; // pool index and amount
+
+private:
+    bool outOfTime()
+    {
+        if ((++mNodes & 1023) == 0 && Clock::now() >= mShared.deadline)
+            mShared.stop = true;
+        return mShared.stop;
+    }
+
+    void record(const double total[4])
+    {
+        double miss = missOf(mShared.goal, total);
+        if (miss >= mBest)
+            return;
+        mBest = miss;
+        mBestItems = mChosen;
+        double shared = mShared.best.load();
+        while (miss < shared && !mShared.best.compare_exchange_weak(shared, miss))
+            ;
+    }
+
+    // adds pool[index] on top of total, then tries every later food after it
+    void tryFood(int depth, int index, const double total[4])
+    {
+        const vector<Candidate> &pool = *mShared.pool;
+        const Candidate &food = pool[index];
+        double next[4];
+        if (depth == mShared.maxFoods - 1)
+        {
+            double amount = bestAmount(mShared.goal, food, total);
+            addAmount(food, amount, total, next);
+            mChosen.push_back(std::make_pair(index, amount));
+            record(next);
+            mChosen.pop_back();
+            outOfTime();
+            return;
+        }
+        for (int step = 1; step <= food.steps; step++)
+        {
+            if (outOfTime())
+                return;
+            double amount = food.step * step;
+            addAmount(food, amount, total, next);
+            // bigger portions only overshoot more
+            if (overshootOf(mShared.goal, next) >= mShared.best.load(std::memory_order_relaxed))
+                break;
+            mChosen.push_back(std::make_pair(index, amount));
+            record(next);
+            for (int later = index + 1; later < (int)pool.size() && !mShared.stop; later++)
+                tryFood(depth + 1, later, next);
+            mChosen.pop_back();
+        }
+    }
+
+    SharedSearch &mShared;
+    vector<std::pair<int, double> > mChosen;
+    long long mNodes;
+};
+
+MealPlanner::MealPlanner()
+{
+    mMaxFoods = 3;
+    mTimeBudget = 1000;
+    mThreads = 0;
+    mPoolSize = 300;
+}
+
+MealPlanner::~MealPlanner()
+{
+
+}
+
+void MealPlanner::setMaxFoods(int foods)
+{
+    mMaxFoods = std::max(foods, 1);
+}
+
+void MealPlanner::setTimeBudget(int milliseconds)
+{
+    mTimeBudget = std::max(milliseconds, 1);
+}
+
+void MealPlanner::setThreads(int threads)
+{
+    mThreads = std::max(threads, 0);
+}
+
+void MealPlanner::setPoolSize(int foods)
+{
+    mPoolSize = std::max(foods, 1);
+}
+
+MealPlan MealPlanner::plan(const vector<Food> &foods, const Macros &remaining) const
+{
+    Clock::time_point started = Clock::now();
+    MealPlan result;
+    result.error = 0.0;
+    result.complete = true;
+    result.nodes = 0;
+
+    // what's left can be negative once a goal is passed, aim for nothing more of that macro
+    const double floors[4] = {100.0, 10.0, 10.0, 5.0};
+    double left[4] = {(double)remaining.getCalories(), remaining.getProteins(), remaining.getCarbs(), remaining.getFats()};
+    Goal goal;
+    bool anythingLeft = false;
+    for (int n = 0; n < 4; n++)
+    {
+        goal.target[n] = std::max(left[n], 0.0);
+        double scale = std::max(goal.target[n], floors[n]);
+        goal.weight[n] = 1.0 / (scale * scale);
+        anythingLeft = anythingLeft || goal.target[n] > 0.0;
+    }
+    double nothing[4] = {0.0, 0.0, 0.0, 0.0};
+    result.error = missOf(goal, nothing);
+    if (!anythingLeft)
+        return result;
+
+    vector<Candidate> pool;
+    for (int position = 0; position < (int)foods.size(); position++)
+    {
+        const Food &food = foods[position];
+        Candidate candidate;
+        candidate.position = position;
+        candidate.byGrams = food.getGrams() > 0;
+        double units = candidate.byGrams ? food.getGrams() : food.getServings();
+        if (units <= 0)
+            continue;
+        double listed[4] = {(double)food.getCal(), food.getProtein(), food.getCarb(), food.getFat()};
+        bool hasAny = false;
+        for (int n = 0; n < 4; n++)
+        {
+            candidate.perUnit[n] = std::max(listed[n], 0.0) / units;
+            hasAny = hasAny || candidate.perUnit[n] > 0.0;
+        }
+        if (!hasAny)
+            continue;
+        // whole grams and whole servings only, that's all a logged food can hold
+        candidate.step = candidate.byGrams ? 25.0 : 1.0;
+        candidate.steps = candidate.byGrams ? 20 : 4;
+        candidate.fineStep = candidate.byGrams ? 5.0 : 1.0;
+        double alone[4];
+        addAmount(candidate, bestAmount(goal, candidate, nothing), nothing, alone);
+        candidate.score = missOf(goal, alone);
+        pool.push_back(candidate);
+    }
+    // best single foods first so good plans turn up early and prune the rest
+    std::sort(pool.begin(), pool.end(), [](const Candidate &a, const Candidate &b) { return a.score < b.score; });
+    if ((int)pool.size() > mPoolSize)
+        pool.resize(mPoolSize);
+    if (pool.empty())
+        return result;
+
+    SharedSearch shared;
+    shared.pool = &pool;
+    shared.goal = goal;
+    shared.maxFoods = mMaxFoods;
+    shared.deadline = started + std::chrono::milliseconds(mTimeBudget);
+    shared.nextFirst = 0;
+    shared.stop = false;
+    shared.best = result.error;
+    shared.nodes = 0;
+
+    int threads = mThreads > 0 ? mThreads : (int)std::thread::hardware_concurrency();
+    threads = std::max(1, std::min(threads, (int)pool.size()));
+    vector<Worker> workers(threads, Worker(shared));
+    vector<std::thread> running;
+    for (int t = 1; t < threads; t++)
+        running.emplace_back(&Worker::run, &workers[t]);
+    workers[0].run();
+    for (auto &thread : running)
+        thread.join();
+
+    const Worker *winner = nullptr;
+    for (const Worker &worker : workers)
+    {
+        if (!worker.mBestItems.empty() && (winner == nullptr || worker.mBest < winner->mBest))
+            winner = &worker;
+    }
+    result.complete = !shared.stop;
+    result.nodes = shared.nodes;
+    if (winner == nullptr || winner->mBest >= result.error)
+        return result;
+
+    result.error = winner->mBest;
+    for (auto &chosen : winner->mBestItems)
+    {
+        const Candidate &food = pool[chosen.first];
+        PlanItem item;
+        item.position = food.position;
+        item.amount = chosen.second;
+        item.byGrams = food.byGrams;
+        item.macros.add((int)round(food.perUnit[0] * chosen.second), food.perUnit[1] * chosen.second, food.perUnit[2] * chosen.second, food.perUnit[3] * chosen.second);
+        result.total.add(item.macros.getCalories(), item.macros.getProteins(), item.macros.getCarbs(), item.macros.getFats());
+        result.items.push_back(item);
+    }
+    return result;
+}
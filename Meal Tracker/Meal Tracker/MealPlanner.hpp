@@ -0,0 +1,60 @@
+//
+//  MealPlanner.hpp
+//  Meal Tracker
+//
+//  Suggests a few dictionary foods and amounts that fill what is left of
+//  the day's macros. Branch and bound over food combinations: portions are
+//  tried smallest first and a branch stops once it overshoots a macro by
+//  more than the best plan found so far misses by. The last food's amount
+//  is solved for directly instead of searched. The first food of each
+//  combination is handed out to worker threads and the search stops when
+//  the time budget runs out, keeping the best plan found until then.
+//
+
+#ifndef MealPlanner_hpp
+#define MealPlanner_hpp
+#include "Food.hpp"
+#include "Macros.hpp"
+#include <vector>
+#include <stdio.h>
+
+using std::vector;
+
+struct PlanItem
+{
+    int position; // where the food is in the dictionary
+    double amount; // whole grams, or whole servings for foods listed by servings
+    bool byGrams;
+    Macros macros; // what this amount of the food adds
+};
+
+struct MealPlan
+{
+    vector<PlanItem> items; // empty when nothing gets closer than eating nothing
+    Macros total;
+    double error; // weighted squared miss relative to the goal, 0 is a perfect fit
+    bool complete; // false when the time budget ran out before the search finished
+    long long nodes; // combinations looked at
+};
+
+class MealPlanner
+{
+public:
+    MealPlanner();
+    ~MealPlanner();
+
+    void setMaxFoods(int foods);
+    void setTimeBudget(int milliseconds);
+    void setThreads(int threads); // 0 uses every core
+    void setPoolSize(int foods); // how many of the best single foods are combined
+
+    MealPlan plan(const vector<Food> &foods, const Macros &remaining) const;
+
+private:
+    int mMaxFoods;
+    int mTimeBudget;
+    int mThreads;
+    int mPoolSize;
+};
+
+#endif /* MealPlanner_hpp */
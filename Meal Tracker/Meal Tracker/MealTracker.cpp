@@ -0,0 +1,783 @@
+//
+//  MealTracker.cpp
+//  Meal Tracker
+//
+
+#include "MealTracker.hpp"
+#include "FoodDataFile.hpp"
+#include "LegacyLog.hpp"
+#include "Dates.hpp"
+#include "SessionStats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::endl;
+using std::ifstream;
+using std::stringstream;
+
+// bytes put in a file since from, only asked for when tracing since tellp flushes the stream
+static void countWritten(std::ostream &out, std::streamoff from = 0)
+{
+    if (!tracingEnabled())
+        return;
+    std::streamoff at = out.tellp();
+    if (at > from)
+        countBytesWritten((uint64_t)(at - from));
+}
+
+MealTracker::MealTracker()
+{
+    mDictionaryChanged = false;
+    mRetryFailedWrites = true;
+    mSyncPolicy = SYNC_COMMIT;
+    const char *sync = getenv("MEAL_TRACKER_FSYNC");
+    if (sync != nullptr && strcmp(sync, "periodic") == 0)
+        mSyncPolicy = SYNC_PERIODIC;
+    else if (sync != nullptr && strcmp(sync, "none") == 0)
+        mSyncPolicy = SYNC_NONE;
+    const char *cap = getenv("MEAL_TRACKER_PROFILE_CACHE_MB");
+    if (cap != nullptr && atoi(cap) > 0)
+        mProfiles.setMemoryCap((size_t)atoi(cap) * 1024 * 1024);
+}
+
+MealTracker::~MealTracker()
+{
+
+}
+
+int MealTracker::loadDictionary()
+{
+    ScopedTimer timer("MealTracker::loadDictionary");
+    int count = -1;
+    vector<Food> foods;
+    if (isSnapshotCurrent("FoodData.bin", "FoodData.csv"))
+        count = loadFoodDataSnapshot("FoodData.bin", foods);
+    if (count < 0)
+    {
+        // no usable snapshot, the csv was edited since the last one was written
+        foods.clear();
+        // stamped before reading, an edit made while it's being read makes the snapshot out of date straight away
+        CsvStamp csv = csvStampOf("FoodData.csv");
+        count = loadFoodDataCsv("FoodData.csv", foods);
+        if (count < 0)
+            return -1;
+        saveFoodDataSnapshot("FoodData.bin", foods, csv);
+    }
+    mDictionary.publish(std::move(foods));
+    mViews.clear();
+    mNutrientIndex.clear();
+    return count;
+}
+
+void MealTracker::saveDictionary()
+{
+    if (!mDictionaryChanged)
+        return; // nothing was added or edited since the dictionary was loaded
+    ScopedTimer timer("MealTracker::saveDictionary");
+    countFileOpen("FoodData.csv");
+    mfoodFile.open("FoodData.csv", std::ios::out | std::ios::trunc);
+    shared_ptr<const DictionarySnapshot> dictionary = mDictionary.snapshot();
+    const vector<Food> &foods = dictionary->foods();
+    for(auto i = foods.begin(); i != foods.end(); ++i)
+    {
+        mfoodFile << i->getName() << "," << i->getGrams() << ","  << i->getServings() <<  "," << i->getCal() << "," << i->getProtein() << ","<< i->getCarb() << "," << i->getFat() << endl;
+    }
+    countWritten(mfoodFile);
+    mfoodFile.close();
+    saveFoodDataSnapshot("FoodData.bin", foods, csvStampOf("FoodData.csv"));
+    mDictionaryChanged = false;
+}
+
+shared_ptr<const DictionarySnapshot> MealTracker::dictionary() const
+{
+    return mDictionary.snapshot();
+}
+
+// Looks a food up by name without caring about case
+int MealTracker::findFood(const string &name) const
+{
+    return mDictionary.current().find(name);
+}
+
+vector<int> MealTracker::suggest(const string &name, int count) const
+{
+    return mDictionary.current().suggest(name, count);
+}
+
+int MealTracker::addFood(const Food &food)
+{
+    int position = mDictionary.add(food);
+    mViews.insert(mDictionary.snapshot()->foods(), position);
+    mNutrientIndex.clear();
+    mDictionaryChanged = true;
+    return position;
+}
+
+bool MealTracker::replaceFood(int position, const Food &food)
+{
+    shared_ptr<const DictionarySnapshot> dictionary = mDictionary.snapshot();
+    if (position < 0 || position >= dictionary->size())
+        return false;
+    Food before = dictionary->food(position);
+    mDictionary.replace(position, food);
+    mViews.update(mDictionary.snapshot()->foods(), position, before);
+    mNutrientIndex.clear();
+    mDictionaryChanged = true;
+    return true;
+}
+
+vector<int> MealTracker::sortedPage(SortKey key, int first, int count, bool highestFirst)
+{
+    return mViews.page(mDictionary.snapshot()->foods(), key, first, count, highestFirst);
+}
+
+vector<int> MealTracker::findByMacros(const NutrientQuery &query)
+{
+    return mNutrientIndex.find(mDictionary.snapshot()->foods(), query);
+}
+
+MealPlan MealTracker::planMeal(int maxFoods)
+{
+    MealPlanner planner;
+    planner.setMaxFoods(maxFoods > 0 ? maxFoods : 3);
+    return planner.plan(mDictionary.snapshot()->foods(), leftToday());
+}
+
+Food MealTracker::portion(const Food &food, double quantity, double servings)
+{
+    Food Macros;
+    double ratio = food.getGrams() == 0 ? servings /(double) food.getServings() : quantity /(double) food.getGrams();
+    double scaled[4] = {(double)food.getCal(), food.getFat(), food.getProtein(), food.getCarb()};
+    scaleColumn(scaled, 4, ratio);
+    Macros.setCal(scaled[0]);
+    Macros.setFat(scaled[1]);
+    Macros.setProtein(scaled[2]);
+    Macros.setCarb(scaled[3]);
+    Macros.setGrams(quantity);
+    Macros.setName(food.getName());
+    Macros.setServings(servings);
+    return Macros;
+}
+
+bool MealTracker::switchUser(const string &name, ProfileReport *report)
+{
+    shared_ptr<Profile> profile = mProfiles.get(name);
+    if (!profile)
+        return false;
+    mUser = profile;
+    if (mUser->loaded)
+        return true;
+    loadProfile();
+    if (report != nullptr)
+        *report = mLastLoad;
+    return true;
+}
+
+Profile &MealTracker::user()
+{
+    return *mUser;
+}
+
+shared_ptr<Profile> MealTracker::currentUser() const
+{
+    return mUser;
+}
+
+// reads the current profile's history, goals and today's totals
+void MealTracker::loadProfile()
+{
+    ScopedTimer timer("MealTracker::loadProfile");
+    mLastLoad = ProfileReport();
+    mLastLoad.readIn = true;
+    mUser->journal.setSyncPolicy(mSyncPolicy);
+    mLastLoad.historyOpened = mUser->history.open(mUser->path("MacrosLog.txt"));
+    for (const auto &day : mUser->history.all())
+    {
+        mUser->stats.addDay(day);
+    }
+    replayJournal();
+    writeToDatesAndMacrosFile();
+    mLastLoad.goalsSet = readMacroGoals();
+    loadDailyMacros();
+    mUser->loaded = true;
+}
+
+bool MealTracker::rollOverDay()
+{
+    if (mUser->macrosDay == epochDayToday())
+        return false;
+    // the day rolled over while the app was open
+    writeDayFiles();
+    writeToDatesAndMacrosFile();
+    // yesterday's foods are in the journal and the day files, their rows go back to the heap in one go
+    mUser->log.discardFront(mUser->dayFilesWritten);
+    mUser->logWritten -= mUser->dayFilesWritten;
+    mUser->logSubmitted -= mUser->dayFilesWritten;
+    mUser->dayFilesWritten = 0;
+    loadDailyMacros();
+    return true;
+}
+
+void MealTracker::logFood(const Food &food)
+{
+    uint64_t allocations = tracingEnabled() ? allocationCount() : 0;
+    mUser->log.add(food);
+    mUser->dailyMacros.add(food.getCal(), food.getProtein(), food.getCarb(), food.getFat());
+    if (tracingEnabled())
+        countMealLogged(1, allocationCount() - allocations);
+}
+
+bool MealTracker::commitLog()
+{
+    ScopedTimer timer("MealTracker::commitLog");
+    bool ok = mUser->journal.wait(submitLog());
+    settleLog();
+    return ok;
+}
+
+shared_ptr<JournalCommit> MealTracker::submitLog()
+{
+    settleLog();
+    time_t now = currentTime();
+    // foods logged before midnight and written after it go in the journal with today's date, so they count
+    // for today too. Yesterday is closed first with what was committed on it
+    if (epochDay(now) != mUser->macrosDay)
+        rollOverDay();
+    vector<Food> unwritten;
+    unwritten.reserve(mUser->log.size() - mUser->logSubmitted);
+    for(int i = mUser->logSubmitted; i < mUser->log.size(); i++)
+    {
+        unwritten.push_back(mUser->log.row(i));
+    }
+    shared_ptr<JournalCommit> commit = mUser->journal.submit(unwritten, now);
+    mUser->logSubmitted = mUser->log.size();
+    mUser->unsettled.push_back(LogCommit{commit, mUser->logSubmitted, now});
+    return commit;
+}
+
+// The journal writes commits in the order they were submitted, and fails every one queued behind a failed
+// write, so the first failure here means nothing after it got to the disk either
+void MealTracker::settleLog()
+{
+    deque<LogCommit> &unsettled = mUser->unsettled;
+    bool ok = true;
+    while (!unsettled.empty() && mUser->journal.finished(unsettled.front().commit, ok))
+    {
+        if (!ok)
+        {
+            unsettled.clear();
+            if (!mRetryFailedWrites)
+            {
+                // everyone who logged these was told it failed, so they're gone rather than written later
+                Macros dropped = mUser->log.totals(mUser->logWritten, mUser->logSubmitted);
+                mUser->dailyMacros.add(-dropped.getCalories(), -dropped.getProteins(), -dropped.getCarbs(), -dropped.getFats());
+                mUser->log.erase(mUser->logWritten, mUser->logSubmitted);
+            }
+            // otherwise they go out again with the next commit
+            mUser->logSubmitted = mUser->logWritten;
+            mUser->journal.recover();
+            return;
+        }
+        markCommitted(unsettled.front().last, unsettled.front().when);
+        unsettled.pop_front();
+    }
+}
+
+void MealTracker::setRetryFailedWrites(bool retry)
+{
+    mRetryFailedWrites = retry;
+}
+
+bool MealTracker::hasUncommittedFood() const
+{
+    return mUser->logWritten != mUser->log.size();
+}
+
+int MealTracker::uncheckpointedFoods() const
+{
+    return mUser->logWritten - mUser->dayFilesWritten;
+}
+
+void MealTracker::markCommitted(int last, time_t when)
+{
+    Macros written = mUser->log.totals(mUser->logWritten, last);
+    mUser->savedMacros.add(written.getCalories(), written.getProteins(), written.getCarbs(), written.getFats());
+    mUser->logWritten = last;
+    mUser->logSubmitted = std::max(mUser->logSubmitted, last);
+    mUser->lastCommit = when;
+}
+
+void MealTracker::writeDayFiles()
+{
+    if (mUser->dayFilesWritten == mUser->logWritten && mUser->unsettled.empty())
+        return;
+    ScopedTimer timer("MealTracker::writeDayFiles");
+    // a checkpoint may only cover commits that are on the disk
+    mUser->journal.flush();
+    settleLog();
+    if (mUser->dayFilesWritten == mUser->logWritten)
+        return;
+    time_t stamp = dayStamp();
+    vector<Food> foods;
+    for (int i = mUser->dayFilesWritten; i < mUser->logWritten; i++)
+    {
+        foods.push_back(mUser->log.row(i));
+    }
+    writeDayFoods(foods, mUser->macrosDay, stamp);
+    writeDayTotals(stamp);
+    mUser->dayFilesWritten = mUser->logWritten;
+}
+
+// The day files have to be dated on the day their totals are for, even when they are written after midnight,
+// or the next start takes yesterday's totals for today's
+time_t MealTracker::dayStamp() const
+{
+    return epochDay(mUser->lastCommit) == mUser->macrosDay ? mUser->lastCommit : noonOf(mUser->macrosDay);
+}
+
+// DayTotals.txt is written beside and renamed over, so it is always a whole checkpoint. The third line says
+// how far into the journal and DayFoods.txt it goes.
+void MealTracker::writeDayTotals(time_t stamp)
+{
+    struct stat foods;
+    long long foodsSize = stat(mUser->path("DayFoods.txt").c_str(), &foods) == 0 ? (long long)foods.st_size : 0;
+    string next = mUser->path("DayTotals.txt.new");
+    countFileOpen(next);
+    DayTotals.open(next, std::ios::out | std::ios::trunc);
+    DayTotals << "Date-" << ctime(&stamp);
+    DayTotals <<  "Calories:" << mUser->savedMacros.getCalories() << "  Protein:" << round(mUser->savedMacros.getProteins()) << "  Carbs:" << round(mUser->savedMacros.getCarbs()) << "  Fats:" << round(mUser->savedMacros.getFats()) << endl;
+    DayTotals << "Journal:" << (long long)mUser->journal.size() << "  Foods:" << foodsSize << endl;
+    countWritten(DayTotals);
+    DayTotals.close();
+    rename(next.c_str(), mUser->path("DayTotals.txt").c_str());
+}
+
+void MealTracker::replayJournal()
+{
+    ScopedTimer timer("MealTracker::replayJournal");
+    string date = "", macros = "", checkpoint = "";
+    countFileOpen(mUser->path("DayTotals.txt"));
+    DayTotals.open(mUser->path("DayTotals.txt"), std::ios::in);
+    getline(DayTotals, date);
+    getline(DayTotals, macros);
+    getline(DayTotals, checkpoint);
+    DayTotals.close();
+
+    long long offset = 0, foodsSize = 0;
+    if (sscanf(checkpoint.c_str(), "Journal:%lld Foods:%lld", &offset, &foodsSize) != 2)
+        return; // written before there were checkpoints, nothing to go on
+    vector<JournalEntry> tail = mUser->journal.readFrom(offset);
+    if (tail.empty())
+        return;
+
+    // anything past the checkpoint in DayFoods.txt is about to be written again
+    truncate(mUser->path("DayFoods.txt").c_str(), (off_t)foodsSize);
+    int day = epochDayFromCtime(date);
+    DayMacros saved;
+    Macros totals;
+    if (MacroHistory::parseMacros(macros, saved))
+        totals.add(saved.calories, saved.protein, saved.carbs, saved.fat);
+    time_t stamp = currentTime();
+    vector<Food> foods;
+    int replayed = 0;
+    for (const JournalEntry &entry : tail)
+    {
+        int entryDay = epochDay((time_t)entry.timestamp);
+        if (entryDay < day)
+            continue; // an import filling in an earlier day, the history has those
+        if (entryDay > day)
+        {
+            // the day moved on before a checkpoint, close the old one like a normal start would
+            if (day >= 0)
+            {
+                writeDayFoods(foods, day, stamp);
+                mUser->savedMacros = totals;
+                writeDayTotals(stamp);
+                writeToDatesAndMacrosFile();
+            }
+            day = entryDay;
+            totals = Macros();
+            foods.clear();
+        }
+        stamp = (time_t)entry.timestamp;
+        totals.add(entry.calories, entry.protein, entry.carbs, entry.fat);
+        foods.push_back(Food(entry.name(), entry.grams, entry.servings, entry.calories, entry.protein, entry.carbs, entry.fat));
+        replayed++;
+    }
+    writeDayFoods(foods, day, stamp);
+    mUser->savedMacros = totals;
+    writeDayTotals(stamp);
+    mLastLoad.recovered = replayed;
+}
+
+// Reads today's saved totals once, after that the profile's dailyMacros is kept up to date in memory as food gets logged
+void MealTracker::loadDailyMacros()
+{
+    ScopedTimer timer("MealTracker::loadDailyMacros");
+    string date = "", macros = "";
+    DayMacros saved;
+
+    countFileOpen(mUser->path("DayTotals.txt"));
+    DayTotals.open(mUser->path("DayTotals.txt"), std::ios::in);
+    getline(DayTotals, date);
+    getline(DayTotals, macros);
+    DayTotals.close();
+    countBytesRead(date.size() + macros.size());
+
+    mUser->macrosDay = epochDayToday();
+    mUser->savedMacros = Macros();
+    if (epochDayFromCtime(date) == mUser->macrosDay && MacroHistory::parseMacros(macros, saved))
+    {
+        mUser->savedMacros.add(saved.calories, saved.protein, saved.carbs, saved.fat);
+    }
+
+    Macros unwritten = mUser->log.totals(mUser->logWritten, mUser->log.size());
+    mUser->dailyMacros = mUser->savedMacros;
+    mUser->dailyMacros.add(unwritten.getCalories(), unwritten.getProteins(), unwritten.getCarbs(), unwritten.getFats());
+}
+
+// Adds the foods to DayFoods.txt, starting it over when it holds a different day
+void MealTracker::writeDayFoods(const vector<Food> &foods, int day, time_t stamp)
+{
+    string date = "";
+    countFileOpen(mUser->path("DayFoods.txt"));
+    mFoodAteTodayFile.open(mUser->path("DayFoods.txt"), std::ios::in);
+    getline(mFoodAteTodayFile, date);
+    mFoodAteTodayFile.close();
+    mFoodAteTodayFile.clear();
+    countBytesRead(date.size());
+
+    std::streamoff start = 0;
+    countFileOpen(mUser->path("DayFoods.txt"));
+    if (epochDayFromCtime(date) != day)
+    {
+        // rewrite
+        mFoodAteTodayFile.open(mUser->path("DayFoods.txt"), std::ofstream::out | std::ofstream::trunc);
+        mFoodAteTodayFile << "Date-" << ctime(&stamp);
+        mFoodAteTodayFile << "---------------------------------------------------------" << endl;
+    }
+    else
+    {
+        // appends to the file
+        mFoodAteTodayFile.open(mUser->path("DayFoods.txt"), std::ios::app);
+        if (tracingEnabled())
+            start = mFoodAteTodayFile.seekp(0, std::ios::end).tellp();
+    }
+    for (const Food &food : foods)
+    {
+        mFoodAteTodayFile << food << endl;
+    }
+    countWritten(mFoodAteTodayFile, start);
+    mFoodAteTodayFile.close();
+}
+
+bool MealTracker::isToday()
+{
+    ScopedTimer timer("MealTracker::isToday");
+    string date = "";
+
+    // get date
+    countFileOpen(mUser->path("DayTotals.txt"));
+    DayTotals.open(mUser->path("DayTotals.txt"));
+    getline(DayTotals, date);
+    DayTotals.close();
+    countBytesRead(date.size());
+
+    return epochDayFromCtime(date) == epochDayToday();
+}
+
+// writes to the history log
+void MealTracker::writeToDatesAndMacrosFile()
+{
+    if (!isToday())
+    {
+        string date = "", macros = "";
+
+        DayMacros day;
+
+        countFileOpen(mUser->path("DayTotals.txt"));
+        DayTotals.open(mUser->path("DayTotals.txt"));
+        getline(DayTotals, date);
+        getline(DayTotals, macros);
+        DayTotals.close();
+
+        day.day = epochDayFromCtime(date);
+        if (day.day < 0 || !MacroHistory::parseMacros(macros, day))
+            return;
+        if (mUser->history.size() > 0 && day.day <= mUser->history.lastDay())
+            return; // this day was already moved into the history on an earlier start
+        mUser->history.append(day);
+        mUser->stats.addDay(day);
+
+        countFileOpen(mUser->path("MacrosLog.txt"));
+        mMacrosLog.open(mUser->path("MacrosLog.txt"), std::ios::app); // make it append
+        mMacrosLog << date << endl;
+        mMacrosLog << macros << endl;
+        mMacrosLog.close();
+        countBytesWritten(date.size() + macros.size() + 2);
+    }
+}
+
+// false when there are no goals in MacroGoals.txt yet, or no MacroGoals.txt
+bool MealTracker::readMacroGoals()
+{
+    countFileOpen(mUser->path("MacroGoals.txt"));
+    mMacroGoals.open(mUser->path("MacroGoals.txt"), std::ios::in);
+
+    if (!mMacroGoals.is_open())
+    {
+        mLastLoad.goalsOpened = false;
+        return false;
+    }
+    string line;
+    getline(mMacroGoals, line);
+    mMacroGoals.close();
+    if (line.empty())
+        return false;
+
+    string proteinStr = "", carbStr = "", calorieStr = "", fatStr = "";
+    stringstream ss(line);
+    getline(ss, calorieStr, ',');
+    getline(ss, proteinStr, ',');
+    getline(ss, carbStr, ',');
+    getline(ss, fatStr, '\n');
+
+    mUser->goalMacros.setCalories(stoi(calorieStr));
+    mUser->goalMacros.setProtein(stoi(proteinStr));
+    mUser->goalMacros.setCarbs(stoi(carbStr));
+    mUser->goalMacros.setFats(stoi(fatStr));
+    return true;
+}
+
+Macros MealTracker::consumedToday() const
+{
+    return mUser->dailyMacros;
+}
+
+Macros MealTracker::leftToday() const
+{
+    Macros left;
+    left.add(mUser->goalMacros.getCalories() - mUser->dailyMacros.getCalories(), mUser->goalMacros.getProteins() - mUser->dailyMacros.getProteins(), mUser->goalMacros.getCarbs() - mUser->dailyMacros.getCarbs(), mUser->goalMacros.getFats() - mUser->dailyMacros.getFats());
+    return left;
+}
+
+Macros MealTracker::sessionTotals() const
+{
+    return mUser->log.totals();
+}
+
+Macros MealTracker::goals() const
+{
+    return mUser->goalMacros;
+}
+
+bool MealTracker::setGoals(const Macros &goal)
+{
+    mUser->goalMacros = goal;
+    countFileOpen(mUser->path("MacroGoals.txt"));
+    mMacroGoals.open(mUser->path("MacroGoals.txt"), std::ofstream::out);
+    if (!mMacroGoals.is_open())
+        return false;
+    mMacroGoals << static_cast<int>(goal.getCalories()) << "," << static_cast<int>(goal.getProteins()) << "," << static_cast<int>(goal.getCarbs()) << "," << static_cast<int>(goal.getFats());
+    countWritten(mMacroGoals);
+    mMacroGoals.close();
+    return true;
+}
+
+vector<DayMacros> MealTracker::history() const
+{
+    return mUser->history.all();
+}
+
+vector<DayMacros> MealTracker::lastDays(int count) const
+{
+    return mUser->history.lastDays(count);
+}
+
+vector<DayMacros> MealTracker::historyRange(int firstDay, int lastDay) const
+{
+    return mUser->history.range(firstDay, lastDay);
+}
+
+const MacroStats &MealTracker::stats() const
+{
+    return mUser->stats;
+}
+
+void MealTracker::rebuildStats()
+{
+    ScopedTimer timer("MealTracker::rebuildStats");
+    // past days can land anywhere in the history, so the statistics start over
+    mUser->stats.clear();
+    for (const auto &day : mUser->history.all())
+        mUser->stats.addDay(day);
+}
+
+// Days before today go straight into the macro history, today's foods are logged like any other so the day files
+// and goals see them. Everything goes into the journal in one write.
+bool MealTracker::importMeals(const string &path, ImportSummary &summary)
+{
+    ScopedTimer timer("MealTracker::importMeals");
+    uint64_t allocations = allocationCount(), inLogFood = 0;
+    MealImport import;
+    summary = ImportSummary();
+    if (!import.read(path, *mDictionary.snapshot()))
+        return false;
+    summary.fileRead = true;
+    rollOverDay(); // today's foods go into the log, which has to be for today
+    if (hasUncommittedFood() && !commitLog())
+        return false;
+
+    vector<JournalEntry> entries;
+    entries.reserve(import.entries().size());
+    int today = epochDayToday();
+    for (const JournalEntry &entry : import.entries())
+    {
+        if (epochDay((time_t)entry.timestamp) > today)
+            summary.future++;
+        else
+            entries.push_back(entry);
+    }
+    // the export renders the journal in order, so keep each day's foods together
+    stable_sort(entries.begin(), entries.end(), [](const JournalEntry &a, const JournalEntry &b) { return a.timestamp < b.timestamp; });
+    summary.report = import.report();
+    if (!mUser->journal.append(entries))
+        return false;
+
+    vector<DayMacros> days;
+    for (const JournalEntry &entry : entries)
+    {
+        int day = epochDay((time_t)entry.timestamp);
+        if (day == today)
+        {
+            Food food(entry.name(), entry.grams, entry.servings, entry.calories, entry.protein, entry.carbs, entry.fat);
+            uint64_t before = allocationCount();
+            logFood(food);
+            inLogFood += allocationCount() - before;
+            summary.todayFoods++;
+            continue;
+        }
+        if (days.empty() || days.back().day != day)
+            days.push_back(DayMacros{day, 0, 0.0, 0.0, 0.0});
+        days.back().calories += entry.calories;
+        days.back().protein += entry.protein;
+        days.back().carbs += entry.carbs;
+        days.back().fat += entry.fat;
+        summary.pastFoods++;
+    }
+    if (!days.empty())
+    {
+        summary.historyWritten = mUser->history.merge(days);
+        rebuildStats();
+    }
+    if (summary.todayFoods > 0)
+        markCommitted(mUser->log.size(), currentTime());
+    // the checkpoint moves past everything imported so a restart doesn't read it back
+    writeDayFiles();
+    writeDayTotals(dayStamp());
+    // today's foods were counted as they went through logFood()
+    countMealLogged(summary.pastFoods, allocationCount() - allocations - inLogFood);
+
+    summary.imported = (int)entries.size();
+    summary.pastDays = (int)days.size();
+    return true;
+}
+
+// Renders FoodLog.txt from the journal, the text log from before the journal is kept at the top
+bool MealTracker::exportFoodLog()
+{
+    ScopedTimer timer("MealTracker::exportFoodLog");
+    countFileOpen(mUser->path("FoodLogLegacy.txt"));
+    ifstream legacy(mUser->path("FoodLogLegacy.txt"));
+    struct stat loaded;
+    if (!legacy.is_open() && stat(mUser->path("FoodLogLegacy.loaded.txt").c_str(), &loaded) != 0)
+    {
+        // first export, whatever FoodLog.txt holds was written before the journal existed
+        rename(mUser->path("FoodLog.txt").c_str(), mUser->path("FoodLogLegacy.txt").c_str());
+        countFileOpen(mUser->path("FoodLogLegacy.txt"));
+        legacy.open(mUser->path("FoodLogLegacy.txt"));
+    }
+
+    countFileOpen(mUser->path("FoodLog.txt"));
+    mFoodLog.open(mUser->path("FoodLog.txt"), std::ios::out | std::ios::trunc);
+    if (!mFoodLog.is_open())
+        return false;
+    if (legacy.is_open() && legacy.peek() != EOF)
+        mFoodLog << legacy.rdbuf();
+    mUser->journal.exportText(mFoodLog);
+    countWritten(mFoodLog);
+    mFoodLog.close();
+    return true;
+}
+
+bool MealTracker::isLegacyLogLoaded()
+{
+    struct stat info;
+    return stat(mUser->path("FoodLogLegacy.loaded.txt").c_str(), &info) == 0;
+}
+
+// moves the foods in the pre-journal FoodLog.txt into the journal with their old dates
+bool MealTracker::loadLegacyLog(LegacyLoadSummary &summary)
+{
+    ScopedTimer timer("MealTracker::loadLegacyLog");
+    summary = LegacyLoadSummary();
+    struct stat info;
+    if (stat(mUser->path("FoodLogLegacy.txt").c_str(), &info) != 0)
+    {
+        // nothing was exported yet, so FoodLog.txt is still the one written before the journal
+        rename(mUser->path("FoodLog.txt").c_str(), mUser->path("FoodLogLegacy.txt").c_str());
+    }
+
+    LegacyLog legacy;
+    int threads = (int)std::thread::hardware_concurrency();
+    if (!legacy.read(mUser->path("FoodLogLegacy.txt"), threads > 0 ? threads : 4))
+        return false;
+    summary.fileRead = true;
+    summary.foods = (int)legacy.entries().size();
+    summary.blocks = legacy.blocks();
+    summary.skipped = legacy.skipped();
+
+    // the old foods go in front so the journal stays in date order
+    vector<JournalEntry> entries = legacy.entries();
+    vector<JournalEntry> current = mUser->journal.readAll();
+    entries.insert(entries.end(), make_move_iterator(current.begin()), make_move_iterator(current.end()));
+    if (!mUser->journal.replaceAll(entries))
+        return false;
+    rename(mUser->path("FoodLogLegacy.txt").c_str(), mUser->path("FoodLogLegacy.loaded.txt").c_str());
+    // offsets into the old journal mean nothing now
+    writeDayFiles();
+    writeDayTotals(dayStamp());
+
+    // days MacrosLog.txt never had get their totals from the old foods, days it has are left alone
+    vector<DayMacros> days;
+    vector<DayMacros> known = mUser->history.all();
+    int today = epochDayToday();
+    for (const JournalEntry &entry : legacy.entries())
+    {
+        int day = epochDay((time_t)entry.timestamp);
+        if (day >= today)
+            continue;
+        auto found = lower_bound(known.begin(), known.end(), day, [](const DayMacros &a, int b) { return a.day < b; });
+        if (found != known.end() && found->day == day)
+            continue;
+        if (days.empty() || days.back().day != day)
+            days.push_back(DayMacros{day, 0, 0.0, 0.0, 0.0});
+        days.back().calories += entry.calories;
+        days.back().protein += entry.protein;
+        days.back().carbs += entry.carbs;
+        days.back().fat += entry.fat;
+    }
+    if (!days.empty())
+    {
+        summary.historyWritten = mUser->history.merge(days);
+        rebuildStats();
+    }
+    summary.daysAdded = (int)days.size();
+    return true;
+}
@@ -0,0 +1,158 @@
+//
+//  MealTracker.hpp
+//  Meal Tracker
+//
+//  The tracker without the menu: the shared food dictionary, the profiles
+//  and everything done to the current one, logging, today's totals, goals,
+//  the macro history and imports. Nothing in here reads cin or writes cout,
+//  it answers with values and reports and whoever drives it (the menu, the
+//  server, --import, the benchmarks) decides what to say. The files are
+//  read and written relative to the working directory like before.
+//
+//  One MealTracker is not safe to use from several threads at once apart
+//  from dictionary(), findFood() and suggest(), which only read a snapshot.
+//
+
+#ifndef MealTracker_hpp
+#define MealTracker_hpp
+#include "Food.hpp"
+#include "Macros.hpp"
+#include "FoodDictionary.hpp"
+#include "DictionaryViews.hpp"
+#include "NutrientIndex.hpp"
+#include "MealPlanner.hpp"
+#include "MealImport.hpp"
+#include "MealJournal.hpp"
+#include "MacroHistory.hpp"
+#include "Profile.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <ctime>
+#include <stdio.h>
+
+using std::string;
+using std::vector;
+using std::shared_ptr;
+using std::fstream;
+
+// what happened while a profile's files were read in
+struct ProfileReport
+{
+    bool readIn = false; // the rest is only filled in when the profile was read in by this switchUser()
+    bool historyOpened = true;
+    bool goalsOpened = true; // MacroGoals.txt is there
+    bool goalsSet = true; // and has goals in it
+    int recovered = 0; // foods put back into the day files from the journal
+};
+
+struct ImportSummary
+{
+    bool fileRead = false; // when this is set and importMeals() is false, the journal couldn't be written
+    int imported = 0;
+    int pastFoods = 0; // went straight into the history
+    int pastDays = 0;
+    int todayFoods = 0; // logged like any other food
+    int future = 0; // dated after today, skipped
+    bool historyWritten = true;
+    ImportReport report;
+};
+
+struct LegacyLoadSummary
+{
+    bool fileRead = false; // there was an old log, same as ImportSummary
+    int foods = 0;
+    int blocks = 0;
+    int skipped = 0; // blocks whose date couldn't be read
+    int daysAdded = 0;
+    bool historyWritten = true;
+};
+
+class MealTracker
+{
+public:
+    MealTracker();
+    ~MealTracker();
+    MealTracker(const MealTracker &) = delete;
+    MealTracker &operator=(const MealTracker &) = delete;
+
+    // the dictionary, shared by every profile
+    int loadDictionary(); // FoodData.bin when it is current, FoodData.csv otherwise, -1 if neither can be read
+    void saveDictionary(); // only writes when something was added or edited
+    shared_ptr<const DictionarySnapshot> dictionary() const;
+    int findFood(const string &name) const; // position in the dictionary, -1 if it isn't in there
+    vector<int> suggest(const string &name, int count) const;
+    int addFood(const Food &food); // returns the new food's position
+    bool replaceFood(int position, const Food &food);
+    vector<int> sortedPage(SortKey key, int first, int count, bool highestFirst); // positions, a page of a sorted order
+    vector<int> findByMacros(const NutrientQuery &query);
+    MealPlan planMeal(int maxFoods); // fills what is left of today's goals
+    static Food portion(const Food &food, double quantity, double servings); // grams for foods listed by weight, servings for the rest
+
+    // the current profile
+    bool switchUser(const string &name, ProfileReport *report = nullptr); // false if the name isn't allowed, reads the profile in the first time
+    Profile &user();
+    shared_ptr<Profile> currentUser() const;
+    bool rollOverDay(); // true if the date moved on and the day was closed
+
+    // logging
+    void logFood(const Food &food); // adds a food to the session log and to today's running totals
+    bool commitLog(); // puts the foods logged since the last commit in the journal, the one write that makes them stick
+    shared_ptr<JournalCommit> submitLog(); // commitLog() without waiting for the disk, settleLog() once the wait is over
+    void settleLog(); // counts the submits that got to the disk as committed, a failed one goes out again next time
+    void setRetryFailedWrites(bool retry); // false drops the foods of a failed write from the log instead, for clients told it failed
+    bool hasUncommittedFood() const;
+    int uncheckpointedFoods() const; // committed but not in the day files yet
+    void writeDayFiles(); // checkpoints today's totals and foods, the journal already has them
+    void loadDailyMacros();
+    bool isToday(); // DayTotals.txt is for today
+
+    // totals and goals
+    Macros consumedToday() const;
+    Macros leftToday() const;
+    Macros sessionTotals() const; // foods logged since the app started
+    Macros goals() const;
+    bool setGoals(const Macros &goal); // false if MacroGoals.txt can't be written
+
+    // history
+    vector<DayMacros> history() const;
+    vector<DayMacros> lastDays(int count) const;
+    vector<DayMacros> historyRange(int firstDay, int lastDay) const;
+    const MacroStats &stats() const;
+
+    // bringing food in and out
+    bool importMeals(const string &path, ImportSummary &summary); // false if the file can't be read or the journal written
+    bool exportFoodLog(); // renders FoodLog.txt from the journal
+    bool isLegacyLogLoaded();
+    bool loadLegacyLog(LegacyLoadSummary &summary); // false if there is no old log or the journal can't be written
+
+private:
+    void loadProfile();
+    void markCommitted(int last, time_t when); // the foods before row last of the session log are in the journal now
+    time_t dayStamp() const; // a time on macrosDay to date the day files with
+    void writeDayTotals(time_t stamp);
+    void writeDayFoods(const vector<Food> &foods, int day, time_t stamp);
+    void replayJournal(); // puts foods committed after the last checkpoint back into the day files
+    void writeToDatesAndMacrosFile();
+    bool readMacroGoals();
+    void rebuildStats();
+
+    FoodDictionary mDictionary; // register of all food items, read from FoodData and shared by every profile
+    DictionaryViews mViews; // sorted orders of the dictionary for printing, the dictionary itself stays in file order
+    NutrientIndex mNutrientIndex; // macro range lookups over the dictionary
+    ProfileStore mProfiles; // everyone who used the tracker this session
+    shared_ptr<Profile> mUser;
+    ProfileReport mLastLoad; // filled in by loadProfile()
+    fstream mfoodFile;
+    fstream mFoodLog; // FoodLog.txt, only written by exportFoodLog()
+    fstream DayTotals;
+    fstream mFoodAteTodayFile;
+    fstream mMacrosLog;
+    fstream mMacroGoals;
+    bool mDictionaryChanged; // set when the dictionary is added to or edited so saveDictionary() knows to write
+    SyncPolicy mSyncPolicy; // MEAL_TRACKER_FSYNC, commit (the default), periodic or none
+    bool mRetryFailedWrites; // a failed write's foods stay in the log for the next commit
+};
+
+#endif /* MealTracker_hpp */
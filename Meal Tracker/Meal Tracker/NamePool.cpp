@@ -0,0 +1,69 @@
+//
+//  NamePool.cpp
+//  Meal Tracker
+//
+
+#include "NamePool.hpp"
+#include <new>
+
+NamePool::NamePool()
+{
+    mCount = 0;
+    mBytes = 0;
+}
+
+NamePool::~NamePool()
+{
+
+}
+
+uint32_t NamePool::intern(string_view name)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    auto found = mIds.find(name);
+    if (found != mIds.end())
+        return found->second;
+
+    uint32_t id = mCount;
+    if (id == UINT32_MAX)
+        throw std::bad_alloc(); // the last id is kept as the "no name" everyone else uses
+    unique_ptr<unique_ptr<string[]>[]> &directory = mDirectories[id >> (CHUNK_BITS + DIRECTORY_BITS)];
+    if (!directory)
+        directory.reset(new unique_ptr<string[]>[1u << DIRECTORY_BITS]);
+    unique_ptr<string[]> &chunk = directory[(id >> CHUNK_BITS) & ((1u << DIRECTORY_BITS) - 1)];
+    if (!chunk)
+        chunk.reset(new string[1u << CHUNK_BITS]);
+    string &stored = chunk[id & ((1u << CHUNK_BITS) - 1)];
+    stored.assign(name.data(), name.size());
+    mIds.emplace(string_view(stored), id);
+    mCount++;
+    mBytes += stored.capacity() > 15 ? stored.capacity() + 1 : 0;
+    return id;
+}
+
+// Whoever got the id got it after the name was stored, so reading it needs no lock
+const string &NamePool::name(uint32_t id) const
+{
+    return mDirectories[id >> (CHUNK_BITS + DIRECTORY_BITS)][(id >> CHUNK_BITS) & ((1u << DIRECTORY_BITS) - 1)][id & ((1u << CHUNK_BITS) - 1)];
+}
+
+uint32_t NamePool::size() const
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mCount;
+}
+
+size_t NamePool::memoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    size_t chunks = ((size_t)mCount + (1u << CHUNK_BITS) - 1) >> CHUNK_BITS;
+    size_t directories = (chunks + (1u << DIRECTORY_BITS) - 1) >> DIRECTORY_BITS;
+    return sizeof(NamePool) + directories * (sizeof(unique_ptr<string[]>) << DIRECTORY_BITS) + chunks * (sizeof(string) << CHUNK_BITS) + mBytes
+        + mIds.size() * (sizeof(string_view) + sizeof(uint32_t) + 2 * sizeof(void *));
+}
+
+NamePool &foodNames()
+{
+    static NamePool pool;
+    return pool;
+}
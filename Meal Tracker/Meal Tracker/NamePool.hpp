@@ -0,0 +1,56 @@
+//
+//  NamePool.hpp
+//  Meal Tracker
+//
+//  One copy of every food name in the process. Logged foods, journal
+//  entries and session logs hold a 4 byte id instead of their own string,
+//  so a name eaten a thousand times is stored once. Ids are never reused
+//  and a name never moves, so a reference to one stays good for the life
+//  of the program and can be read without a lock.
+//
+
+#ifndef NamePool_hpp
+#define NamePool_hpp
+#include <string>
+#include <string_view>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+#include <stdio.h>
+
+using std::string;
+using std::string_view;
+using std::unique_ptr;
+using std::unordered_map;
+
+class NamePool
+{
+public:
+    NamePool();
+    ~NamePool();
+    NamePool(const NamePool &) = delete;
+    NamePool &operator=(const NamePool &) = delete;
+
+    uint32_t intern(string_view name); // the same name, case and all, always gets the same id. Grows as needed, never fails short of memory
+    const string &name(uint32_t id) const;
+    uint32_t size() const;
+    size_t memoryUsage() const; // rough bytes held by the names and the lookup
+
+private:
+    // names are kept in chunks of 1024 that never move, 2048 chunks to a directory and enough directories
+    // for every 32 bit id, each allocated the first time it's needed
+    static const uint32_t CHUNK_BITS = 10;
+    static const uint32_t DIRECTORY_BITS = 11;
+    static const uint32_t MAX_DIRECTORIES = 1u << (32 - CHUNK_BITS - DIRECTORY_BITS);
+
+    mutable std::mutex mLock; // held by intern(), name() doesn't need it
+    unique_ptr<unique_ptr<string[]>[]> mDirectories[MAX_DIRECTORIES];
+    unordered_map<string_view, uint32_t> mIds; // views of the names in mChunks
+    uint32_t mCount;
+    size_t mBytes;
+};
+
+NamePool &foodNames(); // the pool every food name goes into
+
+#endif /* NamePool_hpp */
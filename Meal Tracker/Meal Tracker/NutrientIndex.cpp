@@ -0,0 +1,176 @@
+//
+//  NutrientIndex.cpp
+//  Meal Tracker
+//
+
+#include "NutrientIndex.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static const double NO_VALUE = std::numeric_limits<double>::quiet_NaN();
+
+NutrientQuery::NutrientQuery()
+{
+    for (int n = 0; n < 4; n++)
+    {
+        low[n] = -std::numeric_limits<double>::infinity();
+        high[n] = std::numeric_limits<double>::infinity();
+    }
+    per100Grams = false;
+}
+
+void NutrientQuery::limit(Nutrient nutrient, double lowest, double highest)
+{
+    low[nutrient] = lowest;
+    high[nutrient] = highest;
+}
+
+bool NutrientQuery::isLimited(Nutrient nutrient) const
+{
+    return !std::isinf(low[nutrient]) || !std::isinf(high[nutrient]);
+}
+
+NutrientIndex::NutrientIndex()
+{
+    mBuilt = false;
+}
+
+NutrientIndex::~NutrientIndex()
+{
+
+}
+
+void NutrientIndex::clear()
+{
+    for (int n = 0; n < 4; n++)
+    {
+        mListed.sorted[n].clear();
+        mListed.values[n].clear();
+        mPer100Grams.sorted[n].clear();
+        mPer100Grams.values[n].clear();
+    }
+    mBuilt = false;
+}
+
+void NutrientIndex::build(const vector<Food> &foods)
+{
+    clear();
+    for (int position = 0; position < (int)foods.size(); position++)
+    {
+        const Food &food = foods[position];
+        double listed[4] = {(double)food.getCal(), food.getProtein(), food.getCarb(), food.getFat()};
+        int grams = food.getGrams();
+        for (int n = 0; n < 4; n++)
+        {
+            mListed.values[n].push_back(listed[n]);
+            mListed.sorted[n].push_back({listed[n], position});
+            double scaled = grams > 0 ? listed[n] * 100.0 / grams : NO_VALUE;
+            mPer100Grams.values[n].push_back(scaled);
+            if (grams > 0)
+                mPer100Grams.sorted[n].push_back({scaled, position});
+        }
+    }
+    for (int n = 0; n < 4; n++)
+    {
+        auto byValue = [](const Entry &a, const Entry &b) { return a.value < b.value; };
+        std::sort(mListed.sorted[n].begin(), mListed.sorted[n].end(), byValue);
+        std::sort(mPer100Grams.sorted[n].begin(), mPer100Grams.sorted[n].end(), byValue);
+    }
+    mBuilt = true;
+}
+
+bool NutrientIndex::matches(const NutrientQuery &query, const double values[4])
+{
+    for (int n = 0; n < 4; n++)
+    {
+        // NaN fails both compares, so a food with no value never matches
+        if (!(values[n] >= query.low[n] && values[n] <= query.high[n]))
+            return false;
+    }
+    return true;
+}
+
+vector<int> NutrientIndex::find(const vector<Food> &foods, const NutrientQuery &query)
+{
+    if (!mBuilt)
+        build(foods);
+    const Columns &columns = query.per100Grams ? mPer100Grams : mListed;
+    vector<int> found;
+
+    // find where every limited range sits in its column and start from the narrowest
+    const Entry *first[4], *last[4];
+    int narrowest = -1;
+    for (int n = 0; n < 4; n++)
+    {
+        const vector<Entry> &sorted = columns.sorted[n];
+        first[n] = std::lower_bound(sorted.data(), sorted.data() + sorted.size(), query.low[n], [](const Entry &e, double v) { return e.value < v; });
+        last[n] = std::upper_bound(first[n], sorted.data() + sorted.size(), query.high[n], [](double v, const Entry &e) { return v < e.value; });
+        if (query.isLimited((Nutrient)n) && (narrowest == -1 || last[n] - first[n] < last[narrowest] - first[narrowest]))
+            narrowest = n;
+    }
+    if (narrowest == -1)
+        narrowest = CALORIES; // nothing limited, the whole column is the answer
+    size_t candidates = last[narrowest] - first[narrowest];
+    if (candidates == 0)
+        return found;
+
+    vector<uint64_t> bitmap((foods.size() + 63) / 64, 0);
+    for (const Entry *e = first[narrowest]; e != last[narrowest]; ++e)
+        bitmap[e->position >> 6] |= uint64_t(1) << (e->position & 63);
+
+    for (int n = 0; n < 4; n++)
+    {
+        if (n == narrowest || !query.isLimited((Nutrient)n))
+            continue;
+        if ((size_t)(last[n] - first[n]) > candidates * 8)
+            continue; // a wide range costs more to walk than checking the few candidates directly, done below
+        vector<uint64_t> other(bitmap.size(), 0);
+        for (const Entry *e = first[n]; e != last[n]; ++e)
+            other[e->position >> 6] |= uint64_t(1) << (e->position & 63);
+        candidates = 0;
+        for (size_t w = 0; w < bitmap.size(); w++)
+        {
+            bitmap[w] &= other[w];
+            candidates += __builtin_popcountll(bitmap[w]);
+        }
+        if (candidates == 0)
+            return found;
+    }
+
+    found.reserve(candidates);
+    for (size_t w = 0; w < bitmap.size(); w++)
+    {
+        uint64_t bits = bitmap[w];
+        while (bits != 0)
+        {
+            int position = (int)(w * 64) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            double values[4];
+            for (int n = 0; n < 4; n++)
+                values[n] = columns.values[n][position];
+            if (matches(query, values))
+                found.push_back(position);
+        }
+    }
+    return found;
+}
+
+vector<int> NutrientIndex::scan(const vector<Food> &foods, const NutrientQuery &query)
+{
+    vector<int> found;
+    for (int position = 0; position < (int)foods.size(); position++)
+    {
+        const Food &food = foods[position];
+        double values[4] = {(double)food.getCal(), food.getProtein(), food.getCarb(), food.getFat()};
+        if (query.per100Grams)
+        {
+            int grams = food.getGrams();
+            for (int n = 0; n < 4; n++)
+                values[n] = grams > 0 ? values[n] * 100.0 / grams : NO_VALUE;
+        }
+        if (matches(query, values))
+            found.push_back(position);
+    }
+    return found;
+}
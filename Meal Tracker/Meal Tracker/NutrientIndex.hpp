@@ -0,0 +1,63 @@
+//
+//  NutrientIndex.hpp
+//  Meal Tracker
+//
+//  Finds dictionary foods by macro ranges, like "at least 20g protein and
+//  under 200 calories". Every nutrient has its own sorted column, so each
+//  range is a binary search; the narrowest range picks the candidates and
+//  the others are intersected with a bitmap over dictionary positions.
+//
+
+#ifndef NutrientIndex_hpp
+#define NutrientIndex_hpp
+#include "Food.hpp"
+#include "MacroStats.hpp"
+#include <vector>
+#include <cstdint>
+#include <stdio.h>
+
+using std::vector;
+
+// Ranges are inclusive, a nutrient that isn't limited matches anything
+class NutrientQuery
+{
+public:
+    NutrientQuery();
+    void limit(Nutrient nutrient, double low, double high);
+    bool isLimited(Nutrient nutrient) const;
+
+    double low[4];
+    double high[4];
+    bool per100Grams; // compare per 100g instead of per listed portion, foods listed by servings can't match then
+};
+
+class NutrientIndex
+{
+public:
+    NutrientIndex();
+    ~NutrientIndex();
+
+    void clear(); // the dictionary changed, rebuilt on the next query from the foods passed in
+    vector<int> find(const vector<Food> &foods, const NutrientQuery &query); // dictionary positions of the matching foods, in dictionary order
+    static vector<int> scan(const vector<Food> &foods, const NutrientQuery &query); // same answer from a plain pass over the foods, to check find() against
+
+private:
+    struct Entry
+    {
+        double value;
+        int position;
+    };
+    struct Columns
+    {
+        vector<Entry> sorted[4]; // per nutrient, lowest value first
+        vector<double> values[4]; // per nutrient, by dictionary position, NaN when the food has no value
+    };
+    void build(const vector<Food> &foods);
+    static bool matches(const NutrientQuery &query, const double values[4]);
+
+    Columns mListed; // as written in the dictionary
+    Columns mPer100Grams; // only foods measured by weight
+    bool mBuilt;
+};
+
+#endif /* NutrientIndex_hpp */
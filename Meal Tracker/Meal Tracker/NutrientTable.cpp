@@ -0,0 +1,261 @@
+//
+//  NutrientTable.cpp
+//  Meal Tracker
+//
+
+#include "NutrientTable.hpp"
+#include <algorithm>
+#include <cstring>
+
+// Two doubles per vector, the width of an SSE2 or NEON register. Clang and gcc both understand
+// these vector types, and with AVX enabled the compiler fuses pairs of them into wider registers.
+typedef double double2 __attribute__((vector_size(16)));
+
+static inline double2 load2(const double *values)
+{
+    double2 v;
+    memcpy(&v, values, sizeof(v));
+    return v;
+}
+
+static inline void store2(double *values, double2 v)
+{
+    memcpy(values, &v, sizeof(v));
+}
+
+// Four independent accumulators so the adds don't wait on each other
+double sumColumn(const double *values, size_t count)
+{
+    double2 a = {0.0, 0.0}, b = {0.0, 0.0}, c = {0.0, 0.0}, d = {0.0, 0.0};
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        a += load2(values + i);
+        b += load2(values + i + 2);
+        c += load2(values + i + 4);
+        d += load2(values + i + 6);
+    }
+    a += b;
+    c += d;
+    a += c;
+    double total = a[0] + a[1];
+    for (; i < count; i++)
+        total += values[i];
+    return total;
+}
+
+void scaleColumn(double *values, size_t count, double factor)
+{
+    double2 by = {factor, factor};
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+        store2(values + i, load2(values + i) * by);
+    for (; i < count; i++)
+        values[i] *= factor;
+}
+
+void multiplyColumns(double *values, const double *factors, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        store2(values + i, load2(values + i) * load2(factors + i));
+        store2(values + i + 2, load2(values + i + 2) * load2(factors + i + 2));
+    }
+    for (; i < count; i++)
+        values[i] *= factors[i];
+}
+
+double dotColumns(const double *x, const double *y, size_t count)
+{
+    double2 a = {0.0, 0.0}, b = {0.0, 0.0}, c = {0.0, 0.0}, d = {0.0, 0.0};
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        a += load2(x + i) * load2(y + i);
+        b += load2(x + i + 2) * load2(y + i + 2);
+        c += load2(x + i + 4) * load2(y + i + 4);
+        d += load2(x + i + 6) * load2(y + i + 6);
+    }
+    a += b;
+    c += d;
+    a += c;
+    double total = a[0] + a[1];
+    for (; i < count; i++)
+        total += x[i] * y[i];
+    return total;
+}
+
+// one arena block per block of rows
+static const size_t BLOCK_BYTES = NutrientTable::BLOCK_ROWS * (4 * sizeof(double) + 2 * sizeof(int32_t) + sizeof(uint32_t)) + 64;
+
+NutrientTable::NutrientTable()
+    : mArena(BLOCK_BYTES)
+{
+    mSize = 0;
+}
+
+NutrientTable::~NutrientTable()
+{
+
+}
+
+void NutrientTable::addBlock()
+{
+    Block block;
+    block.calories = mArena.allocateArray<double>(BLOCK_ROWS);
+    block.protein = mArena.allocateArray<double>(BLOCK_ROWS);
+    block.carbs = mArena.allocateArray<double>(BLOCK_ROWS);
+    block.fat = mArena.allocateArray<double>(BLOCK_ROWS);
+    block.grams = mArena.allocateArray<int32_t>(BLOCK_ROWS);
+    block.servings = mArena.allocateArray<int32_t>(BLOCK_ROWS);
+    block.nameIds = mArena.allocateArray<uint32_t>(BLOCK_ROWS);
+    mBlocks.push_back(block);
+}
+
+int NutrientTable::add(const string &name, int grams, int servings, int calories, double protein, double carbs, double fat)
+{
+    return add(foodNames().intern(name), grams, servings, calories, protein, carbs, fat);
+}
+
+int NutrientTable::add(uint32_t nameId, int grams, int servings, int calories, double protein, double carbs, double fat)
+{
+    if (mSize == (int)mBlocks.size() * BLOCK_ROWS)
+        addBlock();
+    Block &block = mBlocks[mSize / BLOCK_ROWS];
+    int at = mSize % BLOCK_ROWS;
+    block.nameIds[at] = nameId;
+    block.grams[at] = grams;
+    block.servings[at] = servings;
+    block.calories[at] = calories;
+    block.protein[at] = protein;
+    block.carbs[at] = carbs;
+    block.fat[at] = fat;
+    return mSize++;
+}
+
+int NutrientTable::add(const Food &food)
+{
+    return add(food.getName(), food.getGrams(), food.getServings(), food.getCal(), food.getProtein(), food.getCarb(), food.getFat());
+}
+
+void NutrientTable::clear()
+{
+    mBlocks.clear();
+    mArena.release();
+    mSize = 0;
+}
+
+void NutrientTable::reserve(size_t rows)
+{
+    mBlocks.reserve((rows + BLOCK_ROWS - 1) / BLOCK_ROWS);
+    while ((size_t)mBlocks.size() * BLOCK_ROWS < rows)
+        addBlock();
+}
+
+void NutrientTable::discardFront(int count)
+{
+    if (count <= 0)
+        return;
+    if (count >= mSize)
+    {
+        clear();
+        return;
+    }
+    // the rows that stay are few, they're copied out and logged again into the emptied arena
+    vector<Food> kept;
+    kept.reserve(mSize - count);
+    for (int i = count; i < mSize; i++)
+        kept.push_back(row(i));
+    clear();
+    for (const Food &food : kept)
+        add(food);
+}
+
+void NutrientTable::erase(int first, int last)
+{
+    first = std::max(first, 0);
+    last = std::min(last, mSize);
+    if (first >= last)
+        return;
+    // only done when a commit fails, rebuilding the arena is simpler than moving every column
+    vector<Food> kept;
+    kept.reserve(mSize - (last - first));
+    for (int i = 0; i < mSize; i++)
+    {
+        if (i < first || i >= last)
+            kept.push_back(row(i));
+    }
+    clear();
+    for (const Food &food : kept)
+        add(food);
+}
+
+int NutrientTable::size() const
+{
+    return mSize;
+}
+
+bool NutrientTable::empty() const
+{
+    return mSize == 0;
+}
+
+Food NutrientTable::row(int i) const
+{
+    const Block &block = mBlocks[i / BLOCK_ROWS];
+    int at = i % BLOCK_ROWS;
+    return Food(foodNames().name(block.nameIds[at]), block.grams[at], block.servings[at], (int)block.calories[at], block.protein[at], block.carbs[at], block.fat[at]);
+}
+
+const string &NutrientTable::name(int i) const
+{
+    return foodNames().name(nameId(i));
+}
+
+size_t NutrientTable::memoryUsage() const
+{
+    return mArena.bytesReserved() + mBlocks.capacity() * sizeof(Block);
+}
+
+uint32_t NutrientTable::nameId(int i) const
+{
+    return mBlocks[i / BLOCK_ROWS].nameIds[i % BLOCK_ROWS];
+}
+
+int NutrientTable::grams(int i) const
+{
+    return mBlocks[i / BLOCK_ROWS].grams[i % BLOCK_ROWS];
+}
+
+int NutrientTable::servings(int i) const
+{
+    return mBlocks[i / BLOCK_ROWS].servings[i % BLOCK_ROWS];
+}
+
+Macros NutrientTable::totals() const
+{
+    return totals(0, size());
+}
+
+// a straight run per block
+Macros NutrientTable::totals(int first, int last) const
+{
+    Macros total;
+    if (first >= last)
+        return total;
+    double calories = 0.0, protein = 0.0, carbs = 0.0, fat = 0.0;
+    while (first < last)
+    {
+        const Block &block = mBlocks[first / BLOCK_ROWS];
+        int at = first % BLOCK_ROWS;
+        size_t count = (size_t)std::min(BLOCK_ROWS - at, last - first);
+        calories += sumColumn(block.calories + at, count);
+        protein += sumColumn(block.protein + at, count);
+        carbs += sumColumn(block.carbs + at, count);
+        fat += sumColumn(block.fat + at, count);
+        first += (int)count;
+    }
+    total.add((int)calories, protein, carbs, fat);
+    return total;
+}
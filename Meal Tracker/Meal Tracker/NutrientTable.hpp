@@ -0,0 +1,81 @@
+//
+//  NutrientTable.hpp
+//  Meal Tracker
+//
+//  Logged foods stored column by column: every calorie value sits next to
+//  the other calorie values, same for protein, carbs and fat. Rows hold
+//  the id of their name in foodNames(), not the name. Adding up a column is a
+//  straight run over one array, which the kernels below do a vector at a
+//  time. The columns come in blocks of BLOCK_ROWS rows carved out of an
+//  arena, so logging a food never moves the ones before it and a day's log
+//  goes back to the heap all at once.
+//
+
+#ifndef NutrientTable_hpp
+#define NutrientTable_hpp
+#include "Food.hpp"
+#include "Macros.hpp"
+#include "NamePool.hpp"
+#include "Arena.hpp"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <stdio.h>
+
+using std::string;
+using std::vector;
+
+// Column kernels, they work on any contiguous run of doubles
+double sumColumn(const double *values, size_t count);
+void scaleColumn(double *values, size_t count, double factor);
+void multiplyColumns(double *values, const double *factors, size_t count); // values[i] *= factors[i]
+double dotColumns(const double *x, const double *y, size_t count);
+
+class NutrientTable
+{
+public:
+    NutrientTable();
+    ~NutrientTable();
+
+    int add(const string &name, int grams, int servings, int calories, double protein, double carbs, double fat); // returns the row
+    int add(const Food &food);
+    int add(uint32_t nameId, int grams, int servings, int calories, double protein, double carbs, double fat);
+    void clear();
+    void reserve(size_t rows);
+    void discardFront(int count); // drops the first count rows, the rest move to the front
+    void erase(int first, int last); // drops rows first up to but not including last, the ones after move up
+
+    int size() const;
+    bool empty() const;
+    Food row(int i) const; // rebuilds the Food for printing or writing out
+    size_t memoryUsage() const; // bytes the arena holds for the columns, the names are counted by the pool
+    const string &name(int i) const;
+    uint32_t nameId(int i) const;
+    int grams(int i) const;
+    int servings(int i) const;
+
+    Macros totals() const;
+    Macros totals(int first, int last) const; // rows first up to but not including last
+
+    static const int BLOCK_ROWS = 256;
+
+private:
+    struct Block
+    {
+        double *calories;
+        double *protein;
+        double *carbs;
+        double *fat;
+        int32_t *grams;
+        int32_t *servings;
+        uint32_t *nameIds;
+    };
+    void addBlock();
+
+    Arena mArena;
+    vector<Block> mBlocks;
+    int mSize;
+};
+
+#endif /* NutrientTable_hpp */
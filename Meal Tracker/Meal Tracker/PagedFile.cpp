@@ -0,0 +1,132 @@
+//
+//  PagedFile.cpp
+//  Meal Tracker
+//
+
+#include "PagedFile.hpp"
+#include "SessionStats.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const size_t WINDOW_BYTES = 64 * 1024;
+
+PagedFile::PagedFile(const string &path, int headerLines, int linesPerRecord, int recordsPerPage)
+{
+    mLinesPerRecord = std::max(linesPerRecord, 1);
+    mRecordsPerPage = std::max(recordsPerPage, 1);
+    countFileOpen(path);
+    mFd = open(path.c_str(), O_RDONLY);
+    if (mFd < 0)
+        return;
+    struct stat info;
+    if (fstat(mFd, &info) != 0)
+    {
+        close(mFd);
+        mFd = -1;
+        return;
+    }
+    mSize = info.st_size;
+    mWindow.resize(WINDOW_BYTES);
+    off_t first = skipLines(0, headerLines);
+    if (first < mSize)
+        mStarts.push_back(first);
+    else
+        mReachedEnd = true; // nothing but the header
+}
+
+PagedFile::~PagedFile()
+{
+    if (mFd >= 0)
+        close(mFd);
+}
+
+off_t PagedFile::skipLines(off_t from, int lines)
+{
+    off_t at = from;
+    while (lines > 0 && at < mSize)
+    {
+        ssize_t got = pread(mFd, mWindow.data(), mWindow.size(), at);
+        if (got <= 0)
+            return mSize;
+        countBytesRead((uint64_t)got);
+        const char *first = mWindow.data(), *last = first + got, *p = first;
+        while (lines > 0 && p < last)
+        {
+            const char *newline = static_cast<const char *>(memchr(p, '\n', last - p));
+            if (newline == nullptr)
+            {
+                p = last;
+                break;
+            }
+            p = newline + 1;
+            lines--;
+        }
+        at += p - first;
+    }
+    return std::min(at, mSize);
+}
+
+bool PagedFile::findNext()
+{
+    if (mReachedEnd || mStarts.empty())
+        return false;
+    off_t next = skipLines(mStarts.back(), mLinesPerRecord * mRecordsPerPage);
+    if (next >= mSize)
+    {
+        mReachedEnd = true;
+        return false;
+    }
+    mStarts.push_back(next);
+    return true;
+}
+
+bool PagedFile::hasPage(int page)
+{
+    if (page < 0)
+        return false;
+    while (page >= (int)mStarts.size() && findNext())
+    {
+    }
+    return page < (int)mStarts.size();
+}
+
+bool PagedFile::isLastPage(int page)
+{
+    return hasPage(page) && !hasPage(page + 1);
+}
+
+int PagedFile::writePage(int page, ostream &out)
+{
+    ScopedTimer timer("PagedFile::writePage");
+    if (!hasPage(page))
+        return 0;
+    off_t start = mStarts[page];
+    off_t end = hasPage(page + 1) ? mStarts[page + 1] : mSize;
+    string text((size_t)(end - start), '\0');
+    size_t done = 0;
+    while (done < text.size())
+    {
+        ssize_t got = pread(mFd, &text[done], text.size() - done, start + (off_t)done);
+        if (got <= 0)
+            break;
+        done += (size_t)got;
+    }
+    text.resize(done);
+    countBytesRead(done);
+    if (text.empty())
+        return 0;
+    if (text.back() != '\n')
+        text += '\n'; // the last line of the file had no end
+    int lines = (int)std::count(text.begin(), text.end(), '\n');
+    out.write(text.data(), (std::streamsize)text.size());
+    out.flush();
+    return (lines + mLinesPerRecord - 1) / mLinesPerRecord;
+}
+
+int PagedFile::pageCount() const
+{
+    return mReachedEnd ? (int)mStarts.size() : -1;
+}
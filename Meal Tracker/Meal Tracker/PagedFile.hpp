@@ -0,0 +1,51 @@
+//
+//  PagedFile.hpp
+//  Meal Tracker
+//
+//  Shows a text file of fixed size records (a food in DayFoods.txt is two
+//  lines) a page at a time. The file is read through a small window and
+//  only where each page starts is remembered, found the first time the
+//  page is asked for, so a day with thousands of foods costs no more memory
+//  than a page of them and going back or to page N doesn't scan it again.
+//
+
+#ifndef PagedFile_hpp
+#define PagedFile_hpp
+#include <string>
+#include <vector>
+#include <ostream>
+#include <sys/types.h>
+#include <stdio.h>
+
+using std::string;
+using std::vector;
+using std::ostream;
+
+class PagedFile
+{
+public:
+    PagedFile(const string &path, int headerLines, int linesPerRecord, int recordsPerPage);
+    ~PagedFile();
+    PagedFile(const PagedFile &) = delete;
+    PagedFile &operator=(const PagedFile &) = delete;
+
+    bool isOpen() const { return mFd >= 0; }
+    bool hasPage(int page); // pages count from 0, reads up to the page the first time
+    bool isLastPage(int page); // true when there is nothing past it, false when it doesn't exist either
+    int writePage(int page, ostream &out); // the page's records in one write and flush, how many there were
+    int pageCount() const; // -1 until a page has been asked for past the end
+
+private:
+    bool findNext(); // the start of the page after the last known one, false at the end of the file
+    off_t skipLines(off_t from, int lines); // where the line that many lines on starts, the file size if it runs out first
+
+    int mFd = -1;
+    off_t mSize = 0;
+    int mLinesPerRecord;
+    int mRecordsPerPage;
+    vector<off_t> mStarts; // mStarts[n] is where page n starts, the last one may be the end of the file
+    bool mReachedEnd = false;
+    vector<char> mWindow; // the only part of the file held in memory while looking for pages
+};
+
+#endif /* PagedFile_hpp */
@@ -0,0 +1,140 @@
+//
+//  Profile.cpp
+//  Meal Tracker
+//
+
+#include "Profile.hpp"
+#include <cctype>
+#include <sys/stat.h>
+
+static string directoryFor(const string &name)
+{
+    return name.empty() ? "" : "profiles/" + name + "/";
+}
+
+Profile::Profile(const string &name)
+    : history(directoryFor(name) + "MacrosHistory.dat", directoryFor(name) + "MacrosHistory.idx"),
+      journal(directoryFor(name) + "FoodLog.journal")
+{
+    mName = name;
+    mDirectory = directoryFor(name);
+    macrosDay = -1;
+    logWritten = 0;
+    logSubmitted = 0;
+    dayFilesWritten = 0;
+    lastCommit = 0;
+    consumedToday = true;
+    loaded = false;
+}
+
+Profile::~Profile()
+{
+
+}
+
+const string &Profile::name() const
+{
+    return mName;
+}
+
+string Profile::path(const string &file) const
+{
+    return mDirectory + file;
+}
+
+bool Profile::hasUnwrittenFood() const
+{
+    return log.size() > logWritten;
+}
+
+size_t Profile::memoryUsage() const
+{
+    size_t bytes = sizeof(Profile);
+    bytes += log.memoryUsage();
+    // a day of stats for each window, plus one index entry per 64 history days
+    bytes += (size_t)(stats.windowCount(7) + stats.windowCount(30) + stats.windowCount(90)) * sizeof(DayMacros);
+    bytes += (size_t)(history.size() / 64 + 1) * 2 * sizeof(int32_t);
+    return bytes;
+}
+
+ProfileStore::ProfileStore(size_t memoryCap)
+{
+    mMemoryCap = memoryCap;
+}
+
+ProfileStore::~ProfileStore()
+{
+
+}
+
+bool ProfileStore::isValidName(const string &name)
+{
+    if (name.size() > 64)
+        return false;
+    for (char ch : name)
+    {
+        if (!std::isalnum(static_cast<unsigned char>(ch)) && ch != '-' && ch != '_')
+            return false;
+    }
+    return true;
+}
+
+shared_ptr<Profile> ProfileStore::get(const string &name)
+{
+    if (!isValidName(name))
+        return shared_ptr<Profile>();
+    auto found = mByName.find(name);
+    if (found != mByName.end())
+    {
+        mRecent.splice(mRecent.begin(), mRecent, found->second);
+        return mRecent.front();
+    }
+
+    if (!name.empty())
+    {
+        mkdir("profiles", 0755);
+        mkdir(("profiles/" + name).c_str(), 0755);
+    }
+    mRecent.push_front(std::make_shared<Profile>(name));
+    mByName[name] = mRecent.begin();
+    shared_ptr<Profile> profile = mRecent.front();
+    evict();
+    return profile;
+}
+
+void ProfileStore::setMemoryCap(size_t bytes)
+{
+    mMemoryCap = bytes;
+    evict();
+}
+
+size_t ProfileStore::memoryUsage() const
+{
+    size_t bytes = 0;
+    for (const auto &profile : mRecent)
+        bytes += profile->memoryUsage();
+    return bytes;
+}
+
+int ProfileStore::size() const
+{
+    return (int)mRecent.size();
+}
+
+// drops profiles from the least recently used end until the rest fit under the cap
+void ProfileStore::evict()
+{
+    size_t bytes = memoryUsage();
+    auto i = mRecent.end();
+    while (bytes > mMemoryCap && i != mRecent.begin())
+    {
+        --i;
+        const shared_ptr<Profile> &profile = *i;
+        // use_count 1 means only the store has it
+        if (profile.use_count() > 1 || profile->hasUnwrittenFood())
+            continue;
+        bytes -= profile->memoryUsage();
+        mByName.erase(profile->name());
+        i = mRecent.erase(i);
+    }
+}
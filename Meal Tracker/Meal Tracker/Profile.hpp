@@ -0,0 +1,102 @@
+//
+//  Profile.hpp
+//  Meal Tracker
+//
+//  One person's side of the tracker: their log, goals, today's totals and
+//  macro history, all kept under profiles/<name>/. The food dictionary is
+//  not in here, everybody shares that. The default profile has no name and
+//  keeps using the files in the working directory like before.
+//
+//  ProfileStore hands profiles out by name, loading them on first use, and
+//  drops the least recently used ones once they take more memory than the
+//  cap. A profile that is still held somewhere or has foods that were not
+//  written yet is never dropped.
+//
+
+#ifndef Profile_hpp
+#define Profile_hpp
+#include "Food.hpp"
+#include "Macros.hpp"
+#include "NutrientTable.hpp"
+#include "MacroHistory.hpp"
+#include "MacroStats.hpp"
+#include "MealJournal.hpp"
+#include <string>
+#include <vector>
+#include <list>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <stdio.h>
+
+using std::string;
+using std::vector;
+using std::list;
+using std::deque;
+using std::shared_ptr;
+using std::unordered_map;
+
+// foods handed to the journal in one submit, settled once it's known whether the write worked
+struct LogCommit
+{
+    shared_ptr<JournalCommit> commit;
+    int last; // the log rows before this one went in it
+    time_t when;
+};
+
+class Profile
+{
+public:
+    Profile(const string &name);
+    ~Profile();
+    Profile(const Profile &) = delete;
+    Profile &operator=(const Profile &) = delete;
+
+    const string &name() const;
+    string path(const string &file) const; // where this profile keeps the given file
+    bool hasUnwrittenFood() const;
+    size_t memoryUsage() const; // rough bytes held in memory
+
+    NutrientTable log; // foods logged this session, one column per nutrient
+    MacroHistory history; // daily totals by epoch day
+    MacroStats stats; // averages over the days in history
+    MealJournal journal; // every food written to the log
+    Macros dailyMacros; // what was eaten today, the saved totals plus anything logged but not written yet
+    Macros savedMacros; // today's totals as they are in DayTotals.txt
+    Macros goalMacros;
+    int macrosDay; // epoch day dailyMacros is for
+    int logWritten; // how many foods at the front of log have been committed to the journal
+    int logSubmitted; // how many have been handed to it, the ones past logWritten may not be on the disk yet
+    deque<LogCommit> unsettled; // the submits past logWritten, oldest first
+    int dayFilesWritten; // how many of those are in DayTotals.txt and DayFoods.txt too
+    time_t lastCommit;
+    bool consumedToday; // show what was eaten instead of what is left
+    bool loaded; // the files have been read in
+
+private:
+    string mName;
+    string mDirectory; // with the trailing slash, empty for the default profile
+};
+
+class ProfileStore
+{
+public:
+    ProfileStore(size_t memoryCap = 64 * 1024 * 1024);
+    ~ProfileStore();
+
+    shared_ptr<Profile> get(const string &name); // empty if the name isn't allowed, not loaded yet if it is new
+    void setMemoryCap(size_t bytes);
+    size_t memoryUsage() const;
+    int size() const;
+
+    static bool isValidName(const string &name); // letters, digits, - and _, the empty name is the default profile
+
+private:
+    void evict();
+
+    list<shared_ptr<Profile> > mRecent; // most recently used first
+    unordered_map<string, list<shared_ptr<Profile> >::iterator> mByName;
+    size_t mMemoryCap;
+};
+
+#endif /* Profile_hpp */
@@ -0,0 +1,1203 @@
+//
+//  RunApp.cpp
+//  Meal Tracker
+//
+
+#include "RunApp.hpp"
+#include "Json.hpp"
+#include "Dates.hpp"
+#include "NamePool.hpp"
+#include "PagedFile.hpp"
+#include "SessionStats.hpp"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <unordered_map>
+#include <csignal>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+RunApp::RunApp ()
+{
+    mInteractive = true;
+}
+
+RunApp::~RunApp ()
+{
+
+}
+
+void RunApp::RunGame()
+{
+    int choice = 0;
+
+
+    readFile();
+    switchUser("");
+    Food foodEntry;
+    do
+    {
+        rollOverDay();
+        printMenu();
+        choice = getChoice();
+        switch (choice){
+            case 1:  foodEntry = calculateFoodMacros();
+                logFood(foodEntry);
+                break;
+            case 2: printMacrosList();
+                break;
+            case 3: printTotalMacros();
+                break;
+            case 4: addFoodToDictionary();
+                break;
+            case 5: printDictionary();
+                break;
+            case 6: saveDictionary();
+                break;
+            case 7: writeToLog();
+                break;
+            case 8: editFood();
+                break;
+            case 9: QuickFood();
+                break;
+            case 10: printFoodAteInSession();
+                break;
+            case 11: printTotalFoodAteInSession();
+                break;
+            case 12: printDatesAndMacros();
+                break;
+            case 13: editMacroGoals();
+                break;
+            case 14: printDetails();
+                break;
+            case 15: EditFoodLog();
+                break;
+            case 16: exportFoodLog();
+                break;
+            case 17: findFoodsByMacros();
+                break;
+            case 18: planMeal();
+                break;
+            case 19: chooseUser();
+                break;
+            case 20: loadLegacyLog();
+                break;
+            case 99:
+                toggleDisplay();
+        }
+    }while (choice != 0);
+    writeDayFiles();
+    saveDictionary();
+    printStats();
+}
+
+void RunApp::printStats()
+{
+    if (!writeSessionTrace())
+        cout << "error Writing the trace file" << endl;
+    if (!sessionStatsEnabled())
+        return;
+    printSessionStats(cout);
+    cout << foodNames().size() << " food names kept once each, about " << foodNames().memoryUsage() / 1024 << " KB" << endl;
+    const NutrientTable &log = mTracker.user().log;
+    if (log.size() > 0)
+        cout << "Logged this session: " << log.size() << " foods, " << log.memoryUsage() / log.size() << " bytes each" << endl;
+}
+
+void RunApp::rollOverDay()
+{
+    mTracker.rollOverDay();
+}
+
+bool RunApp::switchUser(const string &name)
+{
+    ProfileReport loaded;
+    if (!mTracker.switchUser(name, &loaded))
+        return false;
+    if (!loaded.readIn)
+        return true;
+    if (!loaded.historyOpened)
+        cout << "error Opening macro history" << endl;
+    if (loaded.recovered > 0)
+        cout << "Recovered " << loaded.recovered << " foods committed after the last save of the day files" << endl;
+    if (!loaded.goalsOpened)
+        cout << "Failed to open MacroGoals.txt" << endl;
+    else if (!loaded.goalsSet)
+    {
+        cout << "Macro Goals not set." << endl;
+        if (mInteractive)
+            editMacroGoals();
+    }
+    return true;
+}
+
+void RunApp::chooseUser()
+{
+    string name;
+    cout << "Enter the user name, or default for the shared files: ";
+    cin >> name;
+    if (name == "default")
+        name = "";
+    if (mTracker.user().hasUnwrittenFood())
+        cout << "Food logged for this user that was not written to the log stays in memory until you switch back and write it" << endl;
+    writeDayFiles();
+    if (!switchUser(name))
+        cout << "User names can only have letters, numbers, - and _" << endl;
+}
+
+void RunApp::printMacrosConsumedToday()
+{
+    cout << "  Macros consumed" << endl;
+    cout << mTracker.consumedToday() << endl;
+}
+
+void RunApp::printMacrisLeftToday()
+{
+    cout << "  Macros left until goal is reached" << endl;
+    printMacrosLeftUntilDayGoal();
+}
+
+void RunApp::printMenu()
+{
+    cout << "---------------------------------------------------------" << endl;
+    if (mTracker.user().consumedToday)
+        printMacrosConsumedToday();
+    else
+        printMacrisLeftToday();
+    cout << "---------------------------------------------------------" << endl;
+    cout << "0. Exit" << endl;
+    cout << "1. Enter food item" << endl;
+    cout << "2. Print list of food ate today with macros" << endl;
+    cout << "3. Print total macros" << endl;
+    cout << "4. Add food to dictionary" << endl;
+    cout << "5. Print food dictionary" << endl;
+    cout << "6. Save Dictionary file" << endl;
+    cout << "7. Write food to log file" << endl;
+    cout << "8. Edit Food" << endl;
+    cout << "9. Enter quick food" << endl;
+    cout << "10. Print food ate in this session" << endl;
+    cout << "11. Print total macros of food ate in this session" << endl;
+    cout << "12. Print log of macros for each day" << endl;
+    cout << "13. Edit Macro Goals" << endl;
+    cout << "14. Print details" << endl;
+    cout << "15. Edit the food log for today" << endl;
+    cout << "16. Export food log to FoodLog.txt" << endl;
+    cout << "17. Find foods by macros" << endl;
+    cout << "18. Suggest foods for the rest of today" << endl;
+    cout << "19. Switch user" << (mTracker.user().name().empty() ? "" : " (now " + mTracker.user().name() + ")") << endl;
+    cout << "20. Load the old food log into the journal" << endl;
+    cout << "99. Toggle calorie display" << endl;
+    cout << "---------------------------------------------------------" << endl;
+}
+
+
+
+int RunApp::getChoice()
+{
+    int choice = 0;
+    while(true){
+    cin >> choice;
+        if (std::cin.fail()) {
+            // If not, clear the error state
+            std::cin.clear();
+
+            // Ignore the rest of the invalid input
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+            // Inform the user of the invalid input
+            std::cout << "Invalid input. Please enter a valid number." << std::endl;
+        }
+        else
+            break;
+        }
+    return choice;
+}
+
+// Reads the food fils to load it into an array
+int RunApp::readFile()
+{
+    int count = mTracker.loadDictionary();
+    if (count < 0)
+    {
+        cout << "error Opening file" << endl;
+        return 0;
+    }
+    return count;
+}
+
+// Looks a food up by name without caring about case, returns -1 when the food is not in the dictionary
+int RunApp::findFood(const string &name)
+{
+    return mTracker.findFood(name);
+}
+
+// prints the food dictionary in the order picked, a page at a time, the dictionary keeps its order
+void RunApp::printDictionary()
+{
+    shared_ptr<const DictionarySnapshot> dictionary = mTracker.dictionary();
+    const vector<Food> &foods = dictionary->foods();
+    const int pageSize = 20;
+    cout << "1. Sort by name" << endl;
+    cout << "2. Sort by calories" << endl;
+    cout << "3. Sort by protein" << endl;
+    cout << "4. Sort by carbs" << endl;
+    cout << "5. Sort by fats" << endl;
+    int choice = 0;
+    choice = getChoice();
+    bool sorted = choice >= 1 && choice <= 5;
+    if (!sorted)
+        cout << "Invalid choice, pritning unsorted" << endl;
+    bool highestFirst = false;
+    if (sorted)
+    {
+        cout << "1. Lowest first" << endl;
+        cout << "2. Highest first" << endl;
+        highestFirst = getChoice() == 2;
+    }
+    cout << "How many foods do you want to see? (0 for all)" << endl;
+    int limit = getChoice();
+    if (limit <= 0 || limit > (int)foods.size())
+        limit = (int)foods.size();
+
+    for (int first = 0; first < limit; first += pageSize)
+    {
+        int count = std::min(pageSize, limit - first);
+        vector<int> positions;
+        if (sorted)
+            positions = mTracker.sortedPage((SortKey)(choice - 1), first, count, highestFirst);
+        else
+            for (int k = first; k < first + count; k++)
+                positions.push_back(k);
+        for (int k : positions)
+        {
+            cout << foods[k] << endl;
+            cout << endl;
+        }
+        if (first + count < limit)
+        {
+            cout << "Showing " << first + count << " of " << limit << ". Enter 1 for the next page, 0 to stop" << endl;
+            if (getChoice() != 1)
+                break;
+        }
+    }
+}
+
+// asks for a range on each macro and prints the dictionary foods that fit all of them
+void RunApp::findFoodsByMacros()
+{
+    const int pageSize = 20;
+    const string names[4] = {"calories", "protein", "carbs", "fats"};
+    NutrientQuery query;
+    cout << "1. Compare per serving as listed" << endl;
+    cout << "2. Compare per 100 grams" << endl;
+    query.per100Grams = getChoice() == 2;
+    for (int n = 0; n < 4; n++)
+    {
+        double low = -1, high = -1;
+        cout << "Enter the lowest and highest " << names[n] << " (-1 for no limit): ";
+        cin >> low >> high;
+        if (cin.fail())
+        {
+            cin.clear();
+            cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            low = high = -1;
+        }
+        if (low >= 0)
+            query.low[n] = low;
+        if (high >= 0)
+            query.high[n] = high;
+    }
+
+    shared_ptr<const DictionarySnapshot> dictionary = mTracker.dictionary();
+    vector<int> found = mTracker.findByMacros(query);
+    cout << "Found " << found.size() << " foods" << endl;
+    for (int first = 0; first < (int)found.size(); first += pageSize)
+    {
+        int last = std::min(first + pageSize, (int)found.size());
+        for (int k = first; k < last; k++)
+        {
+            cout << dictionary->food(found[k]) << endl;
+            cout << endl;
+        }
+        if (last < (int)found.size())
+        {
+            cout << "Showing " << last << " of " << found.size() << ". Enter 1 for the next page, 0 to stop" << endl;
+            if (getChoice() != 1)
+                break;
+        }
+    }
+}
+
+void RunApp::saveDictionary()
+{
+    mTracker.saveDictionary();
+}
+
+Food RunApp::calculateFoodMacros()
+{
+    string finish = "", foodName = "";
+    double quantity = 0.0, servings = 0;
+    int k = 0;
+    bool valid = false;
+    char choice2;
+    do
+    {
+        cout << "What is the name of the food you wish to log?" << endl;
+        cin.ignore();
+        getline(cin, foodName);
+
+        k = findFood(foodName);
+        valid = k != -1;
+
+        if(!valid)
+        {
+            cout << "The food you entered is not in the registry" << endl;
+            shared_ptr<const DictionarySnapshot> dictionary = mTracker.dictionary();
+            vector<int> suggestions = dictionary->suggest(foodName, 5);
+            if (!suggestions.empty())
+            {
+                cout << "Did you mean:" << endl;
+                for (int j = 0; j < (int)suggestions.size(); j++)
+                {
+                    cout << j + 1 << ") " << dictionary->food(suggestions[j]).getName() << endl;
+                }
+                cout << "Enter the number of the food you meant, or 0 if it is none of these" << endl;
+                int pick = getChoice();
+                if (pick >= 1 && pick <= (int)suggestions.size())
+                {
+                    k = suggestions[pick - 1];
+                    valid = true;
+                    break;
+                }
+            }
+            cout << "Would you like to enter this food in the register? Y or N" << endl;
+            cin >> choice2;
+            if (choice2 == 'Y' || choice2 == 'y')
+            {
+                addFoodToDictionary(foodName);
+                k = findFood(foodName);
+                break;
+            }
+            else
+            {
+                cout << "Enter a food in the dictionary" << endl;
+            }
+
+        }
+    }while (!valid);
+
+
+    // now calculate the macros of that food.
+    shared_ptr<const DictionarySnapshot> dictionary = mTracker.dictionary();
+    const Food &food = dictionary->food(k);
+    if (food.getGrams() == 0)
+    {
+        //it is a servings
+        cout << "How many servings did you have?" << endl;
+        cin >> servings;
+    }
+    else
+    {
+        // it is weighable
+        cout << "How many grams of it did you eat?" << endl;
+        cin >> quantity;
+    }
+    return MealTracker::portion(food, quantity, servings);
+}
+
+void RunApp::printFoodAteInSession()
+{
+    /// Used to print food ate only during that session as data was saved temporarily
+    const NutrientTable &log = mTracker.user().log;
+    for(int i = 0; i < log.size(); i++)
+    {
+        cout << log.row(i) << endl;
+    }
+}
+
+// print macros from calculated servings, a page at a time straight from DayFoods.txt
+void RunApp::printMacrosList()
+{
+    const int pageSize = 20;
+    cout << "Food ate today:" << endl;
+    writeDayFiles();
+
+    // the date and the line under it, then two lines a food
+    PagedFile foods(mTracker.user().path("DayFoods.txt"), 2, 2, pageSize);
+    if (!foods.isOpen())
+        return;
+    cout << "---------------------------------------------------------" << endl;
+    int page = 0;
+    while (foods.writePage(page, cout) > 0)
+    {
+        bool last = foods.isLastPage(page);
+        if (last && page == 0)
+            break; // all of it fit on one page
+        cout << "Page " << page + 1;
+        if (foods.pageCount() > 0)
+            cout << " of " << foods.pageCount();
+        cout << ". Enter 1 for the next page, 2 for the previous page, 3 to go to a page, 0 to stop" << endl;
+        int choice = getChoice();
+        if (choice == 1 && !last)
+            page++;
+        else if (choice == 2)
+            page = std::max(page - 1, 0);
+        else if (choice == 3)
+        {
+            cout << "Which page?";
+            int wanted = getChoice();
+            if (foods.hasPage(wanted - 1))
+                page = wanted - 1;
+            else if (wanted > page + 1)
+            {
+                page = foods.pageCount() - 1;
+                cout << "There are only " << foods.pageCount() << " pages, here is the last one" << endl;
+            }
+        }
+        else
+            break;
+    }
+}
+
+void RunApp::printTotalFoodAteInSession()
+{
+    // Used to print food ate only during that session as data was saved temporarily
+    Macros total = mTracker.sessionTotals();
+    cout << "Calories:" << total.getCalories() << "  Protein:" << round(total.getProteins()) << "  Carbs:" << round(total.getCarbs()) << "  Fats:" << round(total.getFats()) << endl;
+
+}
+
+void RunApp::printTotalMacros()
+{
+    Macros today = mTracker.consumedToday();
+    cout << "Calories:" << round(today.getCalories()) << "  Protein:" << round(today.getProteins()) << "  Carbs:" << round(today.getCarbs()) << "  Fats:" << round(today.getFats()) << endl;
+}
+
+void RunApp::addFoodToDictionary()
+{
+    Food newFood;
+    string name = "";
+    int cals = 0, grams = 0, servings = 0;
+    double protein = 0.0, carbs = 0.0, fats = 0.0;
+    bool weighOrServing = false;
+    cout << "Enter the food name: ";
+    cin.ignore();
+    getline(cin, name);
+    cout << "Is your food meadured by weight(1) or is your food measured by servings(0):";
+    weighOrServing = getChoice();
+    if (weighOrServing)
+    {
+        cout << "Enter the serving size in grams: ";
+        grams = getChoice();
+    }
+    else{
+        cout << "Enter the amount of servings: ";
+        servings = getChoice();
+    }
+    cout << "Enter how many calories are in one serving: ";
+    cals = getChoice();
+    cout << "Enter how much protein is in one serving: ";
+    cin >> protein;
+    cout << "Enter how many carbs are in one serving: ";
+    cin >> carbs;
+    cout << "Enter how many fats are in one serving: ";
+    cin >> fats;
+    newFood.setCal(cals);
+    newFood.setFat(fats);
+    newFood.setProtein(protein);
+    newFood.setCarb(carbs);
+    newFood.setName(name);
+    newFood.setGrams(grams);
+    newFood.setServings(servings);
+    mTracker.addFood(newFood);
+}
+
+void RunApp::addFoodToDictionary(string name)
+{
+    Food newFood;
+    int cals = 0, grams = 0, servings = 0;
+    double protein = 0.0, carbs = 0.0, fats = 0.0;
+    bool weighOrServing = false;
+    cout << "Is your food meadured by weight(1) or is your food measured by servings(0):";
+    cin >> weighOrServing;
+    if (weighOrServing)
+    {
+        cout << "Enter the serving size in grams: ";
+        cin >> grams;
+    }
+    else{
+        cout << "Enter the amount of servings: ";
+        cin >> servings;
+    }
+    cout << "Enter how many calories are in one serving: ";
+    cin >> cals;
+    cout << "Enter how much protein is in one serving: ";
+    cin >> protein;
+    cout << "Enter how many carbs are in one serving: ";
+    cin >> carbs;
+    cout << "Enter how many fats are in one serving: ";
+    cin >> fats;
+    newFood.setCal(cals);
+    newFood.setFat(fats);
+    newFood.setProtein(protein);
+    newFood.setCarb(carbs);
+    newFood.setName(name);
+    newFood.setGrams(grams);
+    newFood.setServings(servings);
+    mTracker.addFood(newFood);
+}
+
+void RunApp::writeToLog()
+{
+    if (!mTracker.hasUncommittedFood())
+    {
+        cout << "No new food to write" << endl;
+        return;
+    }
+    // Appends the foods to the journal, FoodLog.txt is only rendered when exported and the day files when they are next read
+    if (!mTracker.commitLog())
+    {
+        cout << "error Writing food log" << endl;
+    }
+}
+
+void RunApp::writeDayFiles()
+{
+    mTracker.writeDayFiles();
+}
+
+void RunApp::QuickFood()
+{
+    int cals = 0;
+    double protein = 0.0, carbs = 0.0, fats = 0.0;
+    string foodName = "";
+    Food food;
+    cout << "What is the name of the food?";
+    cin.ignore();
+    getline(cin, foodName);
+    cout << "How many calories is it?";
+    cin >> cals;
+    cout << "How many grams of protein are in it?";
+    cin >> protein;
+    cout << "How many grams of carbs are in it?";
+    cin >> carbs;
+    cout << "How many grams of fats are in it?";
+    cin >> fats;
+    food.setCal(cals);
+    food.setProtein(protein);
+    food.setFat(fats);
+    food.setName(foodName);
+    food.setCarb(carbs);
+    logFood(food);
+}
+
+void RunApp::editFood()
+{
+    string name = "", newName = "";
+    int newWeight = 0, newServings = 0, newCal = 0, choice = 0;
+    double newProtein = 0.0, newCarbs = 0.0, newFats = 0.0;
+    int k = 0;
+    cout << "Enter the name of the food you wish to edit: ";
+    cin.ignore();
+    getline(cin, name);
+    k = findFood(name);
+    if (k == -1)
+    {
+        cout << "The food you entered is not in the registry" << endl;
+        return;
+    }
+    Food edited = mTracker.dictionary()->food(k); // changed here, then published to the dictionary
+    do
+    {
+        cout << "What do you wish to edit?" << endl;
+        cout << "1) Name" << endl << "2) Weight" << endl << "3) Servings" << endl << "4) Calories" << endl << "5) Protein" << endl << "6) Carbohydrates" << endl << "7) Fats" << endl << "8) Finished Edititing" << endl;
+        choice = getChoice();
+        switch (choice){
+            case 1: cout << "Enter the new name:";
+                    cin >> newName;
+                edited.setName(newName);
+                break;
+            case 2: cout << "Enter the new weight in grams:";
+                    cin >> newWeight;
+                edited.setGrams(newWeight);
+                break;
+            case 3: cout << "Enter the new servings:";
+                    cin >> newServings;
+                edited.setServings(newServings);
+                break;
+            case 4: cout << "Enter the new calories: ";
+                    cin >> newCal;
+                edited.setCal(newCal);
+                break;
+            case 5: cout << "Enter the new protein:";
+                    cin >> newProtein;
+                edited.setProtein(newProtein);
+                break;
+            case 6: cout << "Enter the new carbohydrates:";
+                    cin >> newCarbs;
+                edited.setCarb(newCarbs);
+                break;
+            case 7: cout << "Enter the new fats: ";
+                    cin >> newFats;
+                edited.setFat(newFats);
+                break;
+        }
+        if (choice >= 1 && choice <= 7)
+            mTracker.replaceFood(k, edited);
+    }while(choice != 8);
+
+}
+
+void RunApp::loadDailyMacros()
+{
+    mTracker.loadDailyMacros();
+}
+
+void RunApp::logFood(Food &food)
+{
+    mTracker.logFood(food);
+}
+
+void RunApp::printDatesAndMacros()
+{
+    vector<DayMacros> days;
+    string first = "", last = "";
+    int count = 0;
+    cout << "1. Print every day" << endl;
+    cout << "2. Print the last number of days" << endl;
+    cout << "3. Print the days between two dates" << endl;
+    switch (getChoice())
+    {
+        case 2:
+            cout << "How many days?";
+            count = getChoice();
+            days = mTracker.lastDays(count);
+            break;
+        case 3:
+            cout << "Enter the first date (YYYY-MM-DD):";
+            cin >> first;
+            cout << "Enter the last date (YYYY-MM-DD):";
+            cin >> last;
+            if (epochDayFromIso(first) < 0 || epochDayFromIso(last) < 0)
+            {
+                cout << "Invalid date" << endl;
+                return;
+            }
+            days = mTracker.historyRange(epochDayFromIso(first), epochDayFromIso(last));
+            break;
+        default:
+            days = mTracker.history();
+    }
+
+    for(const auto &day : days)
+    {
+        cout << "Date-" << isoDate(day.day) << endl;
+        cout << "Calories:" << day.calories << "  Protein:" << round(day.protein) << "  Carbs:" << round(day.carbs) << "  Fats:" << round(day.fat) << endl;
+    }
+    if (days.empty())
+        cout << "No days logged in that range" << endl;
+}
+
+void RunApp::printAverages()
+{
+    ScopedTimer timer("RunApp::printAverages");
+    const MacroStats &stats = mTracker.stats();
+    if (stats.allTime(CALORIES).count() == 0)
+    {
+        cout << "No days logged yet" << endl;
+        return;
+    }
+
+    cout << "Averages:" << endl;
+    cout << "Calories:" << stats.allTime(CALORIES).mean() << "  Proteins:" << stats.allTime(PROTEIN).mean() << "  Carbs:" << stats.allTime(CARBS).mean() << "  Fats:" << stats.allTime(FATS).mean() << endl;
+    cout << "Calories ranged from " << stats.allTime(CALORIES).min() << " to " << stats.allTime(CALORIES).max() << ", give or take " << round(stats.allTime(CALORIES).stddev()) << " a day" << endl;
+
+    // the rolling windows end on the last day that was closed
+    int windows[] = {7, 30, 90};
+    for (int days : windows)
+    {
+        cout << days << " day averages (" << stats.windowCount(days) << " days logged):" << endl;
+        cout << "Calories:" << round(stats.windowMean(days, CALORIES)) << "  Proteins:" << round(stats.windowMean(days, PROTEIN)) << "  Carbs:" << round(stats.windowMean(days, CARBS)) << "  Fats:" << round(stats.windowMean(days, FATS)) << endl;
+    }
+}
+
+Macros RunApp::editMacroGoals()
+{
+    Macros goal;
+    int cals = 0, protein = 0, fats = 0, carbs = 0;
+
+    cout << "What is your calorie goal?";
+    cin >> cals;
+    cout << "What is your protein goal?";
+    cin >> protein;
+    cout << "What is your carbs goal?";
+    cin >> carbs;
+    cout << "What is your fats goal?";
+    cin >> fats;
+    goal.setCalories(cals);
+    goal.setProtein(protein);
+    goal.setCarbs(carbs);
+    goal.setFats(fats);
+
+    if (!mTracker.setGoals(goal))
+        std::cout << "Could not open MacroGoals.txt\n";
+
+    return goal;
+}
+
+void RunApp::printMacroGoals()
+{
+    cout << "  Macro Goals" << endl;
+    cout << mTracker.goals() << endl;
+}
+
+void RunApp::printMacrosLeftUntilDayGoal()
+{
+    Macros left = mTracker.leftToday();
+    Macros shown;
+    // whole numbers, like the goals
+    shown.setCalories((int)left.getCalories());
+    shown.setProtein((int)left.getProteins());
+    shown.setCarbs((int)left.getCarbs());
+    shown.setFats((int)left.getFats());
+    cout << shown << endl ;
+}
+
+void RunApp::planMeal()
+{
+    Macros left = mTracker.leftToday();
+    cout << "  Macros left until goal is reached" << endl;
+    cout << left << endl;
+    if (left.getCalories() <= 0 && left.getProteins() <= 0 && left.getCarbs() <= 0 && left.getFats() <= 0)
+    {
+        cout << "You have already reached your goals for today" << endl;
+        return;
+    }
+    cout << "How many different foods at most? ";
+    int maxFoods = getChoice();
+    shared_ptr<const DictionarySnapshot> dictionary = mTracker.dictionary();
+    MealPlan plan = mTracker.planMeal(maxFoods);
+    if (plan.items.empty())
+    {
+        cout << "Nothing in the dictionary gets closer to the goal" << endl;
+        return;
+    }
+
+    cout << "Suggested foods:" << endl;
+    for (const PlanItem &item : plan.items)
+    {
+        cout << dictionary->food(item.position).getName() << " - " << item.amount << (item.byGrams ? " grams" : " servings") << endl;
+        cout << item.macros << endl;
+    }
+    cout << "Total:" << endl << plan.total << endl;
+    if (!plan.complete)
+        cout << "(stopped searching early, this is the best found in time)" << endl;
+
+    char choice = 'N';
+    cout << "Would you like to log these foods? Y or N" << endl;
+    cin >> choice;
+    if (choice != 'Y' && choice != 'y')
+        return;
+    for (const PlanItem &item : plan.items)
+    {
+        Food food;
+        food.setName(dictionary->food(item.position).getName());
+        // the planner only hands out whole amounts, so these match the macros
+        food.setGrams(item.byGrams ? (int)round(item.amount) : 0);
+        food.setServings(item.byGrams ? 0 : (int)round(item.amount));
+        food.setCal(item.macros.getCalories());
+        food.setProtein(item.macros.getProteins());
+        food.setCarb(item.macros.getCarbs());
+        food.setFat(item.macros.getFats());
+        logFood(food);
+    }
+}
+
+void RunApp::toggleDisplay()
+{
+    if (mTracker.user().consumedToday == false)
+    {
+        mTracker.user().consumedToday = true;
+    }
+    else
+    {
+        mTracker.user().consumedToday = false;
+    }
+}
+
+void RunApp::printDetails()
+{
+    Macros today = mTracker.consumedToday(), goal = mTracker.goals();
+    // Calculate macro percentages
+    double proteinRatio = 0.0, carbRatio = 0.0, fatRatio = 0.0, calorieRatio = 0.0;
+
+    // Avoid divide-by-zero by checking goal values
+    if (goal.getCalories() > 0)
+        calorieRatio = (double)today.getCalories() / goal.getCalories() * 100;
+    if (goal.getProteins() > 0)
+        proteinRatio = (double)today.getProteins() / goal.getProteins() * 100;
+    if (goal.getCarbs() > 0)
+        carbRatio = (double)today.getCarbs() / goal.getCarbs() * 100;
+    if (goal.getFats() > 0)
+        fatRatio = (double)today.getFats() / goal.getFats() * 100;
+
+    printMacrisLeftToday();
+
+    cout << "Ratio of macros consumed today" << endl;
+    // Print results
+    cout << "Calories: " << today.getCalories() << " / " << goal.getCalories()
+         << " (" << calorieRatio << "%)" << endl;
+    cout << "Protein: " << today.getProteins() << " / " << goal.getProteins()
+         << " (" << proteinRatio << "%)" << endl;
+    cout << "Carbs: " << today.getCarbs() << " / " << goal.getCarbs()
+         << " (" << carbRatio << "%)" << endl;
+    cout << "Fats: " << today.getFats() << " / " << goal.getFats()
+    << " (" << fatRatio << "%)" << endl << endl;
+
+    printAverages();
+    cout << endl;
+    printMacroGoals();
+}
+
+void RunApp::EditFoodLog()
+{
+    printMacrosList();
+}
+
+void RunApp::exportFoodLog()
+{
+    if (!mTracker.exportFoodLog())
+    {
+        cout << "error Opening file" << endl;
+        return;
+    }
+    cout << "Food log exported to FoodLog.txt" << endl;
+}
+
+void RunApp::loadLegacyLog()
+{
+    if (mTracker.isLegacyLogLoaded())
+    {
+        cout << "The old food log is already in the journal" << endl;
+        return;
+    }
+    LegacyLoadSummary loaded;
+    if (!mTracker.loadLegacyLog(loaded))
+    {
+        if (loaded.fileRead)
+            cout << "error Writing food log" << endl;
+        else
+            cout << "There is no old food log to load" << endl;
+        return;
+    }
+    if (!loaded.historyWritten)
+        cout << "error Writing macro history" << endl;
+    cout << "Loaded " << loaded.foods << " foods from " << loaded.blocks << " entries, " << loaded.daysAdded << " days added to the history" << endl;
+    if (loaded.skipped > 0)
+        cout << loaded.skipped << " entries had a date that couldn't be read and were left out" << endl;
+}
+
+bool RunApp::RunImport(const string &path, const string &user)
+{
+    mInteractive = false;
+    readFile();
+    if (!switchUser(user))
+    {
+        cout << "error Opening profile " << user << endl;
+        return false;
+    }
+    bool imported = importMeals(path);
+    printStats();
+    return imported;
+}
+
+bool RunApp::importMeals(const string &path)
+{
+    ImportSummary summary;
+    if (!mTracker.importMeals(path, summary))
+    {
+        if (summary.fileRead)
+            cout << "error Writing food log" << endl;
+        else
+            cout << "error Opening " << path << endl;
+        return false;
+    }
+    if (!summary.historyWritten)
+        cout << "error Writing macro history" << endl;
+
+    const ImportReport &report = summary.report;
+    cout << "Imported " << summary.imported << " of " << report.lines << " foods, " << summary.pastFoods << " on " << summary.pastDays << " earlier days and " << summary.todayFoods << " today" << endl;
+    if (report.malformed > 0)
+    {
+        cout << report.malformed << " lines could not be read, starting with line";
+        for (int line : report.badLines)
+            cout << " " << line;
+        cout << endl;
+    }
+    for (const auto &unknown : report.unknownFoods)
+        cout << "Not in the dictionary: " << unknown.first << " (" << unknown.second << " times)" << endl;
+    if (summary.future > 0)
+        cout << summary.future << " foods dated after today were skipped" << endl;
+    return true;
+}
+
+static HttpServer *runningServer = nullptr;
+static const int CHECKPOINT_EVERY = 64; // server mode writes the day files after this many foods, the journal has them before that
+static const size_t MAX_QUICK_NAME = 200; // every name a client sends is kept for the life of the server
+
+static void stopServer(int)
+{
+    if (runningServer != nullptr)
+        runningServer->stop();
+}
+
+static HttpResponse jsonError(int status, const string &message)
+{
+    JsonWriter json;
+    json.beginObject().key("error").value(message).endObject();
+    return HttpResponse(status, json.str());
+}
+
+static void writeMacros(JsonWriter &json, const Macros &macros)
+{
+    json.beginObject();
+    json.key("calories").value(macros.getCalories());
+    json.key("protein").value(macros.getProteins());
+    json.key("carbs").value(macros.getCarbs());
+    json.key("fat").value(macros.getFats());
+    json.endObject();
+}
+
+static void writeFood(JsonWriter &json, const Food &food)
+{
+    json.beginObject();
+    json.key("name").value(food.getName());
+    json.key("grams").value(food.getGrams());
+    json.key("servings").value(food.getServings());
+    json.key("calories").value(food.getCal());
+    json.key("protein").value(food.getProtein());
+    json.key("carbs").value(food.getCarb());
+    json.key("fat").value(food.getFat());
+    json.endObject();
+}
+
+// the named field as a number, false when it is missing or isn't one
+static bool numberField(const unordered_map<string, string> &fields, const string &name, double &out)
+{
+    auto found = fields.find(name);
+    if (found == fields.end() || found->second.empty())
+        return false;
+    char *end = nullptr;
+    out = strtod(found->second.c_str(), &end);
+    return *end == '\0' && std::isfinite(out);
+}
+
+// a number field for an amount or a macro, from 0 up to what fits the int columns with room to spare
+static const double MAX_AMOUNT = 100000.0;
+
+static bool amountField(const unordered_map<string, string> &fields, const string &name, double &out)
+{
+    return numberField(fields, name, out) && out >= 0 && out <= MAX_AMOUNT;
+}
+
+void RunApp::RunServer(int port, int threads)
+{
+    mInteractive = false;
+    // a client told its food wasn't logged may send it again, so a failed write isn't tried again behind its back
+    mTracker.setRetryFailedWrites(false);
+    readFile();
+    {
+        std::lock_guard<std::mutex> lock(mProfileLock);
+        switchUser("");
+    }
+    HttpServer server;
+    if (!server.start(port, threads, [this](const HttpRequest &request) { return handleRequest(request); }))
+    {
+        cout << "Could not listen on port " << port << endl;
+        return;
+    }
+    runningServer = &server;
+    signal(SIGINT, stopServer);
+    signal(SIGTERM, stopServer);
+    cout << "Serving on http://127.0.0.1:" << server.port() << " with " << threads << " threads, Ctrl-C to stop" << endl;
+    server.run();
+    runningServer = nullptr;
+    saveDictionary();
+    printStats();
+}
+
+// GET  /search?q=chick&limit=5                       dictionary autocomplete
+// GET  /totals?user=alice                            eaten today, goals and what is left
+// GET  /goals?user=alice   POST /goals {"user", "calories", "protein", "carbs", "fat"}
+// POST /log {"user", "food", "grams" or "servings"}  logs a dictionary food and writes it straight away
+// POST /quick {"user", "name", "calories", "protein", "carbs", "fat"}
+// GET  /history?user=alice&days=7  or  &from=2025-04-01&to=2025-04-08
+HttpResponse RunApp::handleRequest(const HttpRequest &request)
+{
+    unordered_map<string, string> fields = request.query;
+    if (request.method == "POST")
+    {
+        if (!request.body.empty() && !parseJsonObject(request.body, fields))
+            return jsonError(400, "the body has to be a JSON object of names and plain values");
+    }
+    else if (request.method != "GET")
+        return jsonError(405, "only GET and POST are supported");
+    JsonWriter json;
+
+    if (request.path == "/search")
+    {
+        // only reads a dictionary snapshot, so searches don't wait on anyone
+        double limit = 10;
+        numberField(fields, "limit", limit);
+        limit = std::min(std::max(limit, 1.0), 50.0);
+        shared_ptr<const DictionarySnapshot> dictionary = mTracker.dictionary();
+        vector<int> found = dictionary->suggest(fields["q"], (int)limit);
+        json.beginObject().key("foods").beginArray();
+        for (int position : found)
+            writeFood(json, dictionary->food(position));
+        json.endArray().endObject();
+        return HttpResponse(200, json.str());
+    }
+
+    // the rest works on one person's profile, one request at a time
+    std::unique_lock<std::mutex> lock(mProfileLock);
+    if (!switchUser(fields["user"]))
+        return jsonError(400, "user names can only have letters, numbers, - and _");
+    rollOverDay();
+
+    if (request.path == "/totals" && request.method == "GET")
+    {
+        json.beginObject();
+        json.key("user").value(mTracker.user().name());
+        json.key("date").value(isoDate(mTracker.user().macrosDay));
+        json.key("consumed");
+        writeMacros(json, mTracker.consumedToday());
+        json.key("goals");
+        writeMacros(json, mTracker.goals());
+        json.key("left");
+        writeMacros(json, mTracker.leftToday());
+        json.endObject();
+        return HttpResponse(200, json.str());
+    }
+    if (request.path == "/goals")
+    {
+        if (request.method == "POST")
+        {
+            double values[4];
+            const char *names[4] = {"calories", "protein", "carbs", "fat"};
+            for (int n = 0; n < 4; n++)
+            {
+                if (!amountField(fields, names[n], values[n]))
+                    return jsonError(400, string("goals need a ") + names[n] + " number from 0 to 100000");
+            }
+            Macros goal;
+            goal.add((int)values[0], values[1], values[2], values[3]);
+            if (!mTracker.setGoals(goal))
+                return jsonError(500, "the goals could not be written");
+        }
+        json.beginObject().key("goals");
+        writeMacros(json, mTracker.goals());
+        json.endObject();
+        return HttpResponse(200, json.str());
+    }
+    if ((request.path == "/log" || request.path == "/quick") && request.method == "POST")
+    {
+        Food food;
+        if (request.path == "/log")
+        {
+            int k = findFood(fields["food"]);
+            if (k == -1)
+                return jsonError(400, "that food is not in the dictionary");
+            shared_ptr<const DictionarySnapshot> dictionary = mTracker.dictionary();
+            const Food &listed = dictionary->food(k);
+            double grams = 0.0, servings = 0.0;
+            bool byGrams = listed.getGrams() != 0;
+            if (byGrams ? !numberField(fields, "grams", grams) : !numberField(fields, "servings", servings))
+                return jsonError(400, byGrams ? "this food is measured in grams, send grams" : "this food is measured in servings, send servings");
+            if (grams < 0 || servings < 0 || grams > MAX_AMOUNT || servings > MAX_AMOUNT)
+                return jsonError(400, "amounts have to be from 0 to 100000");
+            // the log keeps whole grams and servings, the macros are for the amount it keeps
+            food = MealTracker::portion(listed, round(grams), round(servings));
+        }
+        else
+        {
+            if (fields["name"].size() > MAX_QUICK_NAME)
+                return jsonError(400, "quick food names can be " + std::to_string(MAX_QUICK_NAME) + " characters at most");
+            double values[4];
+            const char *names[4] = {"calories", "protein", "carbs", "fat"};
+            for (int n = 0; n < 4; n++)
+            {
+                if (!amountField(fields, names[n], values[n]))
+                    return jsonError(400, string("quick food needs a ") + names[n] + " number from 0 to 100000");
+            }
+            food.setName(fields["name"]);
+            food.setCal((int)values[0]);
+            food.setProtein(values[1]);
+            food.setCarb(values[2]);
+            food.setFat(values[3]);
+        }
+        logFood(food);
+        // nobody is going to pick "write to log" for a client, so it is committed now
+        shared_ptr<JournalCommit> commit = mTracker.submitLog();
+        if (mTracker.uncheckpointedFoods() >= CHECKPOINT_EVERY)
+            writeDayFiles();
+        json.beginObject();
+        json.key("logged");
+        writeFood(json, food);
+        json.key("consumed");
+        writeMacros(json, mTracker.consumedToday());
+        json.endObject();
+        // other requests can go ahead while this one waits for the disk, commits that pile up meanwhile go out together.
+        // The next submit for the profile settles it
+        shared_ptr<Profile> user = mTracker.currentUser();
+        lock.unlock();
+        if (!user->journal.wait(commit))
+        {
+            // takes the food back out of the log and today's totals now rather than at the next submit
+            lock.lock();
+            if (switchUser(user->name()))
+                mTracker.settleLog();
+            return jsonError(500, "the food could not be written to the log, it was not logged");
+        }
+        return HttpResponse(200, json.str());
+    }
+    if (request.path == "/history" && request.method == "GET")
+    {
+        vector<DayMacros> days;
+        double count = 0;
+        if (fields.count("from") || fields.count("to"))
+        {
+            int first = epochDayFromIso(fields["from"]), last = epochDayFromIso(fields["to"]);
+            if (first < 0 || last < 0)
+                return jsonError(400, "from and to have to be dates like 2025-04-08");
+            days = mTracker.historyRange(first, last);
+        }
+        else if (fields.count("days"))
+        {
+            if (!numberField(fields, "days", count) || count < 1)
+                return jsonError(400, "days has to be a number, 1 or more");
+            // lastDays stops at the start of the history, this only keeps the cast in range
+            days = mTracker.lastDays((int)std::min(count, 1e9));
+        }
+        else
+            days = mTracker.history();
+        json.beginObject().key("days").beginArray();
+        for (const auto &day : days)
+        {
+            json.beginObject();
+            json.key("date").value(isoDate(day.day));
+            json.key("calories").value(day.calories);
+            json.key("protein").value(day.protein);
+            json.key("carbs").value(day.carbs);
+            json.key("fat").value(day.fat);
+            json.endObject();
+        }
+        json.endArray().endObject();
+        return HttpResponse(200, json.str());
+    }
+    return jsonError(404, "no such endpoint");
+}
@@ -0,0 +1,263 @@
+//
+//  SessionStats.cpp
+//  Meal Tracker
+//
+
+#include "SessionStats.hpp"
+#include "Json.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <vector>
+
+static std::atomic<uint64_t> gMealAllocations(0);
+static std::atomic<int> gMeals(0);
+static std::atomic<uint64_t> gOpens(0);
+static std::atomic<uint64_t> gBytesRead(0);
+static std::atomic<uint64_t> gBytesWritten(0);
+
+static std::map<string, int> &openCounts()
+{
+    static std::map<string, int> counts;
+    return counts;
+}
+
+// the server opens files from several threads
+static std::mutex &countsLock()
+{
+    static std::mutex lock;
+    return lock;
+}
+
+void recordFileOpen(const string &path)
+{
+    gOpens.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(countsLock());
+    openCounts()[path]++;
+}
+
+int fileOpenCount()
+{
+    std::lock_guard<std::mutex> lock(countsLock());
+    int total = 0;
+    for (const auto &count : openCounts())
+        total += count.second;
+    return total;
+}
+
+// AllocationCounter.cpp has the real ones, in a program that links it
+__attribute__((weak)) bool allocationsCounted()
+{
+    return false;
+}
+
+__attribute__((weak)) uint64_t allocationCount()
+{
+    return 0;
+}
+
+void recordMealLogged(int meals, uint64_t allocations)
+{
+    gMeals.fetch_add(meals, std::memory_order_relaxed);
+    gMealAllocations.fetch_add(allocations, std::memory_order_relaxed);
+}
+
+void recordBytesRead(uint64_t bytes)
+{
+    gBytesRead.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void recordBytesWritten(uint64_t bytes)
+{
+    gBytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+static void printTimedScopes(ostream &out);
+
+void printSessionStats(ostream &out)
+{
+    int total = fileOpenCount();
+    std::lock_guard<std::mutex> lock(countsLock());
+    out << "File opens this session: " << total << std::endl;
+    for (const auto &count : openCounts())
+    {
+        out << "  " << count.first << ": " << count.second << std::endl;
+    }
+    if (allocationsCounted())
+        out << "Heap allocations this session: " << allocationCount() << std::endl;
+    int meals = gMeals.load(std::memory_order_relaxed);
+    if (meals > 0 && allocationsCounted())
+    {
+        // with the server taking several clients at once the other threads' allocations land in here too
+        out << "Meals logged: " << meals << ", " << (double)gMealAllocations.load(std::memory_order_relaxed) / meals << " allocations each" << std::endl;
+    }
+    out << "Bytes read: " << gBytesRead.load(std::memory_order_relaxed) << ", written: " << gBytesWritten.load(std::memory_order_relaxed) << std::endl;
+    printTimedScopes(out);
+}
+
+bool sessionStatsEnabled()
+{
+    const char *setting = getenv("MEAL_TRACKER_STATS");
+    return setting != nullptr && setting[0] != '\0' && setting[0] != '0';
+}
+
+static const char *tracePath()
+{
+    const char *path = getenv("MEAL_TRACKER_TRACE");
+    return path != nullptr && path[0] != '\0' ? path : nullptr;
+}
+
+bool gTracing = sessionStatsEnabled() || tracePath() != nullptr;
+static const bool gTraceFile = tracePath() != nullptr;
+static const std::chrono::steady_clock::time_point gStarted = std::chrono::steady_clock::now();
+
+// what one timed call cost, kept for the trace file
+struct TraceEvent
+{
+    const char *name;
+    int thread;
+    int64_t start;
+    int64_t duration;
+    uint64_t allocations;
+    uint64_t opens;
+    uint64_t read;
+    uint64_t written;
+};
+
+// every call under one name added up, for the table
+struct ScopeTotals
+{
+    uint64_t calls = 0;
+    int64_t duration = 0;
+    int64_t longest = 0;
+    uint64_t allocations = 0;
+    uint64_t opens = 0;
+    uint64_t read = 0;
+    uint64_t written = 0;
+};
+
+struct NameOrder
+{
+    bool operator()(const char *a, const char *b) const { return strcmp(a, b) < 0; }
+};
+
+// a trace of a long server run is cut off here, about 15 MB of events
+static const size_t MAX_TRACE_EVENTS = 250000;
+
+struct Trace
+{
+    Trace()
+    {
+        // reserved up front so recording an event doesn't allocate inside someone else's scope
+        if (gTraceFile)
+            events.reserve(MAX_TRACE_EVENTS);
+    }
+
+    std::mutex lock;
+    std::map<const char *, ScopeTotals, NameOrder> totals;
+    std::vector<TraceEvent> events;
+    uint64_t dropped = 0;
+};
+
+static Trace &trace()
+{
+    static Trace recorded;
+    return recorded;
+}
+
+static int64_t traceClock()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - gStarted).count();
+}
+
+static int traceThread()
+{
+    static std::atomic<int> threads(0);
+    thread_local int thread = ++threads;
+    return thread;
+}
+
+void ScopedTimer::start()
+{
+    mStarted = true;
+    mAllocations = allocationCount();
+    mOpens = gOpens.load(std::memory_order_relaxed);
+    mRead = gBytesRead.load(std::memory_order_relaxed);
+    mWritten = gBytesWritten.load(std::memory_order_relaxed);
+    mStart = traceClock();
+}
+
+void ScopedTimer::stop()
+{
+    TraceEvent event;
+    event.duration = traceClock() - mStart;
+    event.name = mName;
+    event.thread = traceThread();
+    event.start = mStart;
+    event.allocations = allocationCount() - mAllocations;
+    event.opens = gOpens.load(std::memory_order_relaxed) - mOpens;
+    event.read = gBytesRead.load(std::memory_order_relaxed) - mRead;
+    event.written = gBytesWritten.load(std::memory_order_relaxed) - mWritten;
+
+    Trace &recorded = trace();
+    std::lock_guard<std::mutex> lock(recorded.lock);
+    ScopeTotals &totals = recorded.totals[mName];
+    totals.calls++;
+    totals.duration += event.duration;
+    totals.longest = std::max(totals.longest, event.duration);
+    totals.allocations += event.allocations;
+    totals.opens += event.opens;
+    totals.read += event.read;
+    totals.written += event.written;
+    if (!gTraceFile)
+        return;
+    if (recorded.events.size() < MAX_TRACE_EVENTS)
+        recorded.events.push_back(event);
+    else
+        recorded.dropped++;
+}
+
+static void printTimedScopes(ostream &out)
+{
+    Trace &recorded = trace();
+    std::lock_guard<std::mutex> lock(recorded.lock);
+    if (recorded.totals.empty())
+        return;
+    out << "Timed calls this session:" << std::endl;
+    out << std::left << "  " << std::setw(32) << "name" << std::right << std::setw(8) << "calls" << std::setw(12) << "total ms" << std::setw(12) << "mean us" << std::setw(12) << "max us" << std::setw(10) << "allocs" << std::setw(8) << "opens" << std::setw(12) << "read KB" << std::setw(12) << "written KB" << std::endl;
+    bool counted = allocationsCounted();
+    std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(1);
+    for (const auto &scope : recorded.totals)
+    {
+        const ScopeTotals &totals = scope.second;
+        out << std::left << "  " << std::setw(32) << scope.first << std::right << std::setw(8) << totals.calls << std::setw(12) << totals.duration / 1e6 << std::setw(12) << totals.duration / 1e3 / totals.calls << std::setw(12) << totals.longest / 1e3 << std::setw(10) << (counted ? std::to_string(totals.allocations) : "-") << std::setw(8) << totals.opens << std::setw(12) << totals.read / 1024.0 << std::setw(12) << totals.written / 1024.0 << std::endl;
+    }
+    out.flags(flags);
+    if (recorded.dropped > 0)
+        out << recorded.dropped << " calls left out of the trace file, it stops at " << MAX_TRACE_EVENTS << std::endl;
+}
+
+bool writeSessionTrace()
+{
+    if (!gTraceFile)
+        return true;
+    const char *path = tracePath();
+    FILE *out = fopen(path, "w");
+    if (out == nullptr)
+        return false;
+    Trace &recorded = trace();
+    std::lock_guard<std::mutex> lock(recorded.lock);
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (size_t i = 0; i < recorded.events.size(); i++)
+    {
+        const TraceEvent &event = recorded.events[i];
+        fprintf(out, "%s{\"name\":%s,\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"allocations\":%llu,\"opens\":%llu,\"read\":%llu,\"written\":%llu}}", i > 0 ? ",\n" : "", jsonQuote(event.name).c_str(), event.thread, event.start / 1e3, event.duration / 1e3, (unsigned long long)event.allocations, (unsigned long long)event.opens, (unsigned long long)event.read, (unsigned long long)event.written);
+    }
+    fprintf(out, "\n]}\n");
+    return fclose(out) == 0;
+}
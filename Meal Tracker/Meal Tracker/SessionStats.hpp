@@ -0,0 +1,94 @@
+//
+//  SessionStats.hpp
+//  Meal Tracker
+//
+//  Counts how many times each data file gets opened during a session, and
+//  how many heap allocations it takes to log a meal when the program links
+//  AllocationCounter.cpp, which replaces operator new. Also the bytes read
+//  and written, and ScopedTimers around the slow paths that note what each
+//  call cost.
+//  Set MEAL_TRACKER_STATS=1 to have the counts and a table of the timed
+//  scopes printed on exit, MEAL_TRACKER_TRACE=file to also get every timed
+//  call as a Chrome trace (chrome://tracing or ui.perfetto.dev).
+//
+
+#ifndef SessionStats_hpp
+#define SessionStats_hpp
+#include <string>
+#include <ostream>
+#include <cstdint>
+#include <stdio.h>
+
+using std::string;
+using std::ostream;
+
+extern bool gTracing; // MEAL_TRACKER_STATS or MEAL_TRACKER_TRACE is set, read once at startup
+
+inline bool tracingEnabled()
+{
+    return gTracing;
+}
+
+// the count* calls are inline so that with tracing off they're the flag check and nothing else
+void recordFileOpen(const string &path);
+void recordMealLogged(int meals, uint64_t allocations);
+void recordBytesRead(uint64_t bytes);
+void recordBytesWritten(uint64_t bytes);
+
+inline void countFileOpen(const string &path)
+{
+    if (gTracing)
+        recordFileOpen(path);
+}
+
+// allocations spent logging meals, meals may be 0 for work done for earlier ones
+inline void countMealLogged(int meals, uint64_t allocations)
+{
+    if (gTracing)
+        recordMealLogged(meals, allocations);
+}
+
+inline void countBytesRead(uint64_t bytes)
+{
+    if (gTracing)
+        recordBytesRead(bytes);
+}
+
+inline void countBytesWritten(uint64_t bytes)
+{
+    if (gTracing)
+        recordBytesWritten(bytes);
+}
+
+int fileOpenCount(); // opens of every file added together
+bool allocationsCounted(); // AllocationCounter.cpp is linked in
+uint64_t allocationCount(); // operator new calls since the program started, 0 when they aren't counted
+void printSessionStats(ostream &out);
+bool sessionStatsEnabled();
+bool writeSessionTrace(); // to MEAL_TRACKER_TRACE when it's set, false if it's set and can't be written
+
+// Times the scope it lives in under name, a string literal, along with the files opened, bytes read and
+// written and allocations made in it. Nested and other threads' work lands in it too. When tracing is off
+// it's a flag check and nothing else
+class ScopedTimer
+{
+public:
+    ScopedTimer(const char *name) : mName(name) { if (gTracing) start(); }
+    ~ScopedTimer() { if (mStarted) stop(); }
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+    void start();
+    void stop();
+
+    const char *mName;
+    bool mStarted = false;
+    int64_t mStart = 0; // nanoseconds since the program started
+    uint64_t mAllocations = 0;
+    uint64_t mOpens = 0;
+    uint64_t mRead = 0;
+    uint64_t mWritten = 0;
+};
+
+#endif /* SessionStats_hpp */
@@ -10,6 +10,7 @@
 #include "RunApp.hpp"
 #include <iostream>
 #include <fstream>
+#include <thread>
 
 
 using std::fstream;
@@ -18,7 +19,33 @@ using std::fstream;
 int main(int argc, const char * argv[]) {
     // insert code here...
     RunApp Ass;
-    Ass.RunGame();
+    // --serve [port] [--threads n] answers JSON requests on localhost instead of showing the menu
+    // --import <file or -> [--user name] logs the foods in a CSV or JSONL file and exits
+    bool serve = false;
+    string importPath = "", user = "";
+    int port = 8080, threads = (int)std::thread::hardware_concurrency();
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--serve")
+        {
+            serve = true;
+            if (i + 1 < argc && isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+                port = atoi(argv[++i]);
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (arg == "--import" && i + 1 < argc)
+            importPath = argv[++i];
+        else if (arg == "--user" && i + 1 < argc)
+            user = argv[++i];
+    }
+    if (!importPath.empty())
+        return Ass.RunImport(importPath, user) ? 0 : 1;
+    if (serve)
+        Ass.RunServer(port, threads > 0 ? threads : 4);
+    else
+        Ass.RunGame();
     
     return 0;
 }
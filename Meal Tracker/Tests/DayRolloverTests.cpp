@@ -0,0 +1,177 @@
+//
+//  DayRolloverTests.cpp
+//  Meal Tracker
+//
+//  day_rollover_tests
+//
+//  Runs a profile across midnight with the clock set by hand: foods logged
+//  before midnight and written after it, and a write handed to the journal
+//  before midnight that is only settled after it. Yesterday has to end up
+//  in the history with what was committed on it, and today has to start
+//  from nothing, in memory and after a restart. Works in a directory of
+//  its own and exits non-zero and says what differed on a failure.
+//
+
+#include "MealTracker.hpp"
+#include "MacroHistory.hpp"
+#include "Dates.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <unistd.h>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+static int gFailures = 0;
+
+static void check(bool ok, const string &what)
+{
+    if (!ok)
+    {
+        cout << "FAILED: " << what << endl;
+        gFailures++;
+    }
+}
+
+static void checkCalories(int actual, int expected, const string &what)
+{
+    check(actual == expected, what + ": got " + std::to_string(actual) + ", expected " + std::to_string(expected));
+}
+
+static Food quickFood(const string &name, int calories)
+{
+    return Food(name, 0, 1, calories, 1.0, 2.0, 3.0);
+}
+
+// the day and totals DayTotals.txt holds, -1 for the day when it can't be read
+static DayMacros dayTotals()
+{
+    string date, macros;
+    std::ifstream file("DayTotals.txt");
+    getline(file, date);
+    getline(file, macros);
+    DayMacros day = {-1, 0, 0.0, 0.0, 0.0};
+    if (MacroHistory::parseMacros(macros, day))
+        day.day = epochDayFromCtime(date);
+    return day;
+}
+
+static int caloriesOn(const vector<DayMacros> &history, int day)
+{
+    for (const DayMacros &macros : history)
+    {
+        if (macros.day == day)
+            return macros.calories;
+    }
+    return -1;
+}
+
+static time_t at(int day, int hour, int minute)
+{
+    return (time_t)day * 86400 + hour * 3600 + minute * 60; // the test runs in UTC
+}
+
+// the menu's way: foods sit in the log until "write to log", which is picked after midnight
+static void testCommitAfterMidnight(int first)
+{
+    MealTracker tracker;
+    setCurrentTime(at(first, 23, 50));
+    check(tracker.switchUser(""), "the default profile loads");
+    tracker.logFood(quickFood("Before", 100));
+    check(tracker.commitLog(), "commit before midnight");
+    tracker.writeDayFiles();
+    tracker.logFood(quickFood("Late", 50));
+
+    setCurrentTime(at(first + 1, 0, 5));
+    check(tracker.commitLog(), "commit after midnight");
+    checkCalories(caloriesOn(tracker.history(), first), 100, "yesterday is in the history with what was committed on it");
+    check(tracker.user().macrosDay == first + 1, "the totals are for today after the commit");
+    checkCalories(tracker.consumedToday().getCalories(), 50, "today has the food written after midnight");
+
+    tracker.writeDayFiles();
+    DayMacros saved = dayTotals();
+    check(saved.day == first + 1, "DayTotals.txt is dated today");
+    checkCalories(saved.calories, 50, "DayTotals.txt has today's totals");
+    check(!tracker.rollOverDay(), "nothing is left to roll over");
+}
+
+// the server's way: the write is handed over before midnight and settled by the first request after it
+static void testSettleAfterMidnight(int first)
+{
+    MealTracker tracker;
+    setCurrentTime(at(first, 23, 59));
+    check(tracker.switchUser(""), "the default profile loads again");
+    checkCalories(tracker.consumedToday().getCalories(), 50, "a restart the same day reads the totals back");
+    tracker.logFood(quickFood("Midnight snack", 30));
+    tracker.submitLog();
+
+    setCurrentTime(at(first + 1, 0, 1));
+    check(tracker.rollOverDay(), "the day rolls over");
+    checkCalories(caloriesOn(tracker.history(), first), 80, "the settled write counts for the day it was made on");
+    checkCalories(tracker.consumedToday().getCalories(), 0, "today starts from nothing");
+    tracker.writeDayFiles();
+    check(dayTotals().day == first, "with nothing written today DayTotals.txt still holds yesterday");
+}
+
+static void testRestart(int first)
+{
+    MealTracker tracker;
+    setCurrentTime(at(first, 8, 0));
+    check(tracker.switchUser(""), "the default profile loads after the days rolled over");
+    checkCalories(tracker.consumedToday().getCalories(), 0, "a restart on a new day starts from nothing");
+    vector<DayMacros> history = tracker.history();
+    check(history.size() == 2, "two days in the history, got " + std::to_string(history.size()));
+    checkCalories(caloriesOn(history, first - 2), 100, "the first day after a restart");
+    checkCalories(caloriesOn(history, first - 1), 80, "the second day after a restart");
+}
+
+static void removeAll(const string &directory)
+{
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr)
+        return;
+    while (struct dirent *entry = readdir(dir))
+    {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+            unlink((directory + "/" + entry->d_name).c_str());
+    }
+    closedir(dir);
+    rmdir(directory.c_str());
+}
+
+int main()
+{
+    setenv("TZ", "UTC", 1);
+    tzset();
+    char directory[] = "/tmp/day_rollover_tests_XXXXXX";
+    if (mkdtemp(directory) == nullptr || chdir(directory) != 0)
+    {
+        cout << "could not make a directory to work in" << endl;
+        return 2;
+    }
+
+    int first = epochDayFromCivil(2025, 4, 8);
+    testCommitAfterMidnight(first);
+    testSettleAfterMidnight(first + 1);
+    testRestart(first + 2);
+    setCurrentTime(0);
+
+    if (chdir("/") == 0)
+        removeAll(directory);
+
+    if (gFailures > 0)
+    {
+        cout << gFailures << " checks failed" << endl;
+        return 1;
+    }
+    cout << "all checks passed" << endl;
+    return 0;
+}
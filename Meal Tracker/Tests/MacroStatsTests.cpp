@@ -0,0 +1,325 @@
+//
+//  MacroStatsTests.cpp
+//  Meal Tracker
+//
+//  macro_stats_tests <MacrosLog.txt>
+//
+//  Checks MacroStats and MacroHistory against the MacrosLog.txt that comes
+//  with the app: the history and the statistics are worked out again here
+//  the slow way, with a linear scan of the text log and two pass means,
+//  and have to agree. Exits non-zero and says what differed on a failure.
+//
+
+#include "MacroHistory.hpp"
+#include "MacroStats.hpp"
+#include "Dates.hpp"
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+static int gFailures = 0;
+
+static void check(bool ok, const string &what)
+{
+    if (!ok)
+    {
+        cout << "FAILED: " << what << endl;
+        gFailures++;
+    }
+}
+
+static bool near(double a, double b)
+{
+    return fabs(a - b) <= 1e-9 * std::max(1.0, std::max(fabs(a), fabs(b)));
+}
+
+static void checkNear(double actual, double expected, const string &what)
+{
+    check(near(actual, expected), what + ": got " + std::to_string(actual) + ", expected " + std::to_string(expected));
+}
+
+static void checkSame(const vector<DayMacros> &actual, const vector<DayMacros> &expected, const string &what)
+{
+    bool same = actual.size() == expected.size();
+    for (size_t i = 0; same && i < actual.size(); i++)
+    {
+        same = actual[i].day == expected[i].day && actual[i].calories == expected[i].calories && actual[i].protein == expected[i].protein
+            && actual[i].carbs == expected[i].carbs && actual[i].fat == expected[i].fat;
+    }
+    check(same, what + ": " + std::to_string(actual.size()) + " days, expected " + std::to_string(expected.size()));
+}
+
+// The log read the slow way, a day logged twice keeps its last totals like the history does
+static std::map<int, DayMacros> readLog(const string &path)
+{
+    static const char *MONTHS = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    std::map<int, DayMacros> days;
+    std::ifstream log(path);
+    string date, macros;
+    while (getline(log, date) && getline(log, macros))
+    {
+        char weekday[4], month[4];
+        int dayOfMonth = 0, hour = 0, minute = 0, second = 0, year = 0;
+        if (sscanf(date.c_str(), "Date-%3s %3s %d %d:%d:%d %d", weekday, month, &dayOfMonth, &hour, &minute, &second, &year) != 7)
+            continue;
+        const char *found = strstr(MONTHS, month);
+        if (found == nullptr)
+            continue;
+        DayMacros day;
+        day.day = epochDayFromCivil(year, (int)(found - MONTHS) / 3 + 1, dayOfMonth);
+        double values[4];
+        const char *at = macros.c_str();
+        for (int i = 0; i < 4; i++)
+        {
+            at = strchr(at, ':');
+            values[i] = at != nullptr ? atof(++at) : 0.0;
+        }
+        day.calories = (int32_t)values[0];
+        day.protein = values[1];
+        day.carbs = values[2];
+        day.fat = values[3];
+        days[day.day] = day;
+    }
+    return days;
+}
+
+static vector<DayMacros> scan(const std::map<int, DayMacros> &days, int firstDay, int lastDay)
+{
+    vector<DayMacros> found;
+    for (const auto &day : days)
+    {
+        if (day.first >= firstDay && day.first <= lastDay)
+            found.push_back(day.second);
+    }
+    return found;
+}
+
+static double valueOf(const DayMacros &day, Nutrient nutrient)
+{
+    switch (nutrient)
+    {
+        case CALORIES: return day.calories;
+        case PROTEIN: return day.protein;
+        case CARBS: return day.carbs;
+        default: return day.fat;
+    }
+}
+
+static void testRunningStat()
+{
+    // 2, 4, 4, 4, 5, 5, 7, 9: mean 5, sample variance 32 / 7
+    RunningStat stat;
+    double values[] = {2, 4, 4, 4, 5, 5, 7, 9};
+    for (double value : values)
+        stat.add(value);
+    check(stat.count() == 8, "RunningStat count");
+    checkNear(stat.mean(), 5.0, "RunningStat mean");
+    checkNear(stat.variance(), 32.0 / 7.0, "RunningStat variance");
+    checkNear(stat.min(), 2.0, "RunningStat min");
+    checkNear(stat.max(), 9.0, "RunningStat max");
+
+    // large values close together are where the naive sum of squares loses it
+    RunningStat shifted;
+    for (double value : values)
+        shifted.add(1e9 + value);
+    check(fabs(shifted.variance() - 32.0 / 7.0) < 1e-6, "RunningStat variance of shifted values: got " + std::to_string(shifted.variance()));
+
+    RunningStat one;
+    one.add(3.5);
+    check(one.variance() == 0.0 && one.mean() == 3.5, "RunningStat with one value");
+}
+
+static void testStats(const std::map<int, DayMacros> &expected, const vector<DayMacros> &history)
+{
+    MacroStats stats;
+    for (const DayMacros &day : history)
+        stats.addDay(day);
+    check(stats.latestDay() == expected.rbegin()->first, "latest day");
+
+    Nutrient nutrients[] = {CALORIES, PROTEIN, CARBS, FATS};
+    const char *names[] = {"calories", "protein", "carbs", "fat"};
+    for (Nutrient nutrient : nutrients)
+    {
+        string name = names[nutrient];
+        double sum = 0.0, low = 1e300, high = -1e300;
+        for (const auto &day : expected)
+        {
+            double value = valueOf(day.second, nutrient);
+            sum += value;
+            low = std::min(low, value);
+            high = std::max(high, value);
+        }
+        double mean = sum / expected.size(), squares = 0.0;
+        for (const auto &day : expected)
+            squares += (valueOf(day.second, nutrient) - mean) * (valueOf(day.second, nutrient) - mean);
+        const RunningStat &all = stats.allTime(nutrient);
+        check(all.count() == (int)expected.size(), "all time count of " + name);
+        checkNear(all.mean(), mean, "all time mean of " + name);
+        checkNear(all.variance(), squares / (expected.size() - 1), "all time variance of " + name);
+        checkNear(all.min(), low, "all time min of " + name);
+        checkNear(all.max(), high, "all time max of " + name);
+
+        int windows[] = {7, 30, 90};
+        for (int days : windows)
+        {
+            vector<DayMacros> inside = scan(expected, stats.latestDay() - days + 1, stats.latestDay());
+            double windowSum = 0.0;
+            for (const DayMacros &day : inside)
+                windowSum += valueOf(day, nutrient);
+            double windowMean = windowSum / inside.size(), windowSquares = 0.0;
+            for (const DayMacros &day : inside)
+                windowSquares += (valueOf(day, nutrient) - windowMean) * (valueOf(day, nutrient) - windowMean);
+            string window = std::to_string(days) + " day ";
+            check(stats.windowCount(days) == (int)inside.size(), window + "count");
+            checkNear(stats.windowMean(days, nutrient), windowMean, window + "mean of " + name);
+            if (inside.size() > 1)
+            {
+                double stddev = sqrt(windowSquares / (inside.size() - 1));
+                check(fabs(stats.windowStddev(days, nutrient) - stddev) < 1e-6 * std::max(1.0, stddev), window + "stddev of " + name);
+            }
+        }
+    }
+}
+
+// Decades of days with big totals close together, where sliding a sum of squares along loses the spread
+static void testLongWindows()
+{
+    MacroStats stats;
+    vector<DayMacros> days;
+    int first = epochDayFromCivil(1900, 1, 1);
+    for (int i = 0; i < 50000; i++)
+    {
+        DayMacros day = {first + i, 2000 + (i * 37) % 500, 1e8 + (i * 7919) % 13 * 0.25, 250.0 + i % 11, 1e6 + (i % 5) * 0.1};
+        days.push_back(day);
+        stats.addDay(day);
+    }
+    Nutrient nutrients[] = {CALORIES, PROTEIN, CARBS, FATS};
+    int windows[] = {7, 30, 90};
+    for (int window : windows)
+    {
+        for (Nutrient nutrient : nutrients)
+        {
+            double sum = 0.0;
+            for (int i = (int)days.size() - window; i < (int)days.size(); i++)
+                sum += valueOf(days[i], nutrient);
+            double mean = sum / window, squares = 0.0;
+            for (int i = (int)days.size() - window; i < (int)days.size(); i++)
+                squares += (valueOf(days[i], nutrient) - mean) * (valueOf(days[i], nutrient) - mean);
+            double stddev = sqrt(squares / (window - 1));
+            string what = std::to_string(window) + " day window after 50000 days, nutrient " + std::to_string(nutrient);
+            checkNear(stats.windowMean(window, nutrient), mean, what + " mean");
+            check(fabs(stats.windowStddev(window, nutrient) - stddev) < 1e-6 * std::max(1.0, stddev), what + " stddev: got " + std::to_string(stats.windowStddev(window, nutrient)) + ", expected " + std::to_string(stddev));
+        }
+    }
+}
+
+static void testRanges(const MacroHistory &history, const std::map<int, DayMacros> &expected, const string &what)
+{
+    int first = expected.begin()->first, last = expected.rbegin()->first;
+    checkSame(history.all(), scan(expected, first, last), what + " all()");
+    checkSame(history.range(first, last), scan(expected, first, last), what + " range over everything");
+    checkSame(history.range(first - 100, first - 1), {}, what + " range before the first day");
+    checkSame(history.range(last + 1, last + 100), {}, what + " range after the last day");
+    checkSame(history.range(last, first), {}, what + " range backwards");
+    for (int from = first - 3; from <= last + 3; from += 5)
+    {
+        for (int length = 0; length < 200; length += 13)
+        {
+            checkSame(history.range(from, from + length), scan(expected, from, from + length), what + " range from day " + std::to_string(from) + " for " + std::to_string(length + 1));
+        }
+    }
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 2)
+    {
+        cout << "usage: macro_stats_tests <MacrosLog.txt>" << endl;
+        return 2;
+    }
+    string logPath = argv[1];
+    char directory[] = "/tmp/macro_stats_tests_XXXXXX";
+    if (mkdtemp(directory) == nullptr)
+    {
+        cout << "could not make a directory to work in" << endl;
+        return 2;
+    }
+    string work = directory;
+
+    testRunningStat();
+    testLongWindows();
+
+    std::map<int, DayMacros> expected = readLog(logPath);
+    int entries = 0;
+    {
+        std::ifstream log(logPath);
+        string line;
+        while (getline(log, line))
+            entries += line.compare(0, 5, "Date-") == 0;
+    }
+    check(!expected.empty(), "MacrosLog.txt has days in it");
+    check(entries == (int)expected.size() + 1, "MacrosLog.txt has the one day that was logged twice, Apr 18 2025");
+
+    {
+        MacroHistory history(work + "/MacrosHistory.dat", work + "/MacrosHistory.idx");
+        check(history.open(logPath), "history opens from MacrosLog.txt");
+        check(history.size() == (int)expected.size(), "the day logged twice is in the history once");
+        check(history.range(epochDayFromCivil(2025, 4, 18), epochDayFromCivil(2025, 4, 18)).size() == 1, "Apr 18 2025 comes back once");
+        check(history.lastDay() == expected.rbegin()->first, "history last day");
+        testRanges(history, expected, "MacrosLog.txt");
+        checkSame(history.lastDays(0), {}, "lastDays(0)");
+        checkSame(history.lastDays(-5), {}, "lastDays of a negative count");
+        checkSame(history.lastDays(INT_MAX), history.all(), "lastDays of more days than there are");
+        testStats(expected, history.all());
+    }
+    {
+        // opened again the data file and the index are read back instead of the text log
+        MacroHistory reopened(work + "/MacrosHistory.dat", work + "/MacrosHistory.idx");
+        check(reopened.open(logPath), "history opens again");
+        testRanges(reopened, expected, "reopened");
+    }
+
+    // MacrosLog.txt fits in one index block, a few years with gaps checks the index lookups
+    {
+        MacroHistory years(work + "/Years.dat", work + "/Years.idx");
+        check(years.open(work + "/missing.txt"), "an empty history opens");
+        std::map<int, DayMacros> written;
+        int day = epochDayFromCivil(2020, 1, 1);
+        for (int i = 0; i < 1500; i++)
+        {
+            day += 1 + (i * 7919) % 5 / 3; // every so often a day or two with nothing logged
+            DayMacros macros = {day, 1500 + (i * 37) % 1000, 100.0 + i % 50, 200.0 + i % 70, 50.0 + i % 30};
+            check(years.append(macros), "append");
+            written[day] = macros;
+        }
+        testRanges(years, written, "generated history");
+        testStats(written, years.all());
+    }
+
+    unlink((work + "/MacrosHistory.dat").c_str());
+    unlink((work + "/MacrosHistory.idx").c_str());
+    unlink((work + "/Years.dat").c_str());
+    unlink((work + "/Years.idx").c_str());
+    rmdir(work.c_str());
+
+    if (gFailures > 0)
+    {
+        cout << gFailures << " checks failed" << endl;
+        return 1;
+    }
+    cout << "all checks passed" << endl;
+    return 0;
+}